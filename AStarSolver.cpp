@@ -0,0 +1,181 @@
+#include "AStarSolver.h"
+#include "Common.h"
+#include <numeric>
+#include <optional>
+
+/**
+ * @brief Inverse of a modulo m by the extended Euclidean algorithm. Requires gcd(a, m) = 1; returns 0 when m = 1.
+ */
+static uint64_t ModInverse(uint64_t a, uint64_t m)
+{
+    int64_t oldR = int64_t(a % m), r = int64_t(m);
+    int64_t oldX = 1, x = 0;
+
+    while (r != 0)
+    {
+        int64_t q = oldR / r;
+        int64_t t = oldR - q * r; oldR = r; r = t;
+        t = oldX - q * x; oldX = x; x = t;
+    }
+
+    return uint64_t((oldX % int64_t(m) + int64_t(m)) % int64_t(m));
+}
+
+/**
+ * @brief Precomputes the constants of the ring and the position of the goal.
+ *
+ * The capacities fit a StateIndex, so L + S < 2^31 and every product below fits 64 bits.
+ */
+AStarSolver::Ring::Ring(uint64_t _L, uint64_t _S, uint64_t W) : L(_L), S(_S)
+{
+    g = std::gcd(L, S);
+    lcm = L / g * S;
+    Sg = S / g;
+    invLargeMod = ModInverse((L / g) % Sg, Sg);
+
+    // (0, S) ends the last pour: every earlier multiple of S was emptied, every earlier multiple of L refilled
+    fullSmall = Pours(lcm) + (lcm / S - 1) + (lcm / L - 1);
+    length = fullSmall + 2;
+
+    goal = Position(W, 0);
+    hubDistance = std::min({ Distance(0, goal), Distance(fullSmall, goal), Distance(fullSmall + 1, goal) });
+}
+
+/**
+ * @brief Solves for the amount poured P, then counts the operations of cycle A up to the state.
+ *
+ * Up to P, cycle A made Pours(P) pours, one empty of S per multiple of S and one fill of L per
+ * multiple of L (after the first fill, which position 0 already includes). A state that ends a
+ * pour comes before the empty or fill that follows it.
+ */
+uint64_t AStarSolver::Ring::Position(uint64_t big, uint64_t small) const
+{
+    if (big == L && small == 0)
+        return 0;
+    if (big == 0 && small == S)
+        return fullSmall;
+    if (big == L && small == S)
+        return fullSmall + 1;
+
+    // === P = L*t - big, with P = r (mod S): t = (r + big)/g * (L/g)^-1 (mod S/g) ===
+    bool smallEdge = big != 0 && big != L;         // small is 0 or S, so P is a multiple of S
+    uint64_t r = smallEdge ? 0 : small;
+    uint64_t t = ((r + big) / g % Sg) * invLargeMod % Sg;
+    int64_t P = int64_t(L * t) - int64_t(big);
+    if (P <= 0)
+        P += int64_t(lcm);
+
+    uint64_t p = uint64_t(P);
+    uint64_t operations = Pours(p) + p / S + p / L;
+    if (smallEdge)
+        return small == S ? operations - 1 : operations;    // (b, S) ends a pour, (b, 0) follows the empty
+    return big == 0 ? operations - 1 : operations;          // (0, s) ends a pour, (L, s) follows the fill
+}
+
+/**
+ * @brief Picks the heuristic, prepares the pooled buffers, then runs the search and rebuilds the path.
+ */
+AStarSolver::Result AStarSolver::Solve(int L, int S, int W)
+{
+    if (S < 0 || L <= S)
+        throw std::invalid_argument("AStarSolver: capacities must satisfy 0 <= S < L");
+
+    Result result;
+    if (W < 0 || W > L || W % std::gcd(L, S) != 0)   // every reachable amount is a multiple of gcd(L, S)
+        return result;
+
+    SearchStats& stats = result.stats;
+    StateIndex states(L, S);
+    uint32_t n = states.size();
+
+    // === The ring bound needs a small jug and a goal on the ring; otherwise h = 0 ===
+    std::optional<Ring> ring;
+    if (S > 0 && W > 0)
+        ring.emplace(uint64_t(L), uint64_t(S), uint64_t(W));
+    result.informed = ring.has_value();
+
+    // === Prepare the pooled buffers (no allocation unless n is a new maximum) ===
+    {
+        auto buildTimer = stats.Time(SearchPhase::Build);
+        std::size_t before = MemoryBytes();
+        closed.Reset(n);
+        via.Reserve(n);
+        queue.Reset(2);     // f grows by at most 2 per operation
+        stats.Allocate(MemoryBytes() - before);
+    }
+
+    bool found;
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        found = Search(states, L, S, W, ring ? &*ring : nullptr, result);
+    }
+    if (!found)
+        return result;
+
+    {
+        auto pathTimer = stats.Time(SearchPhase::Path);
+        // Every closed state was popped from a parent one operation closer, so InverseMove finds it as in a BFS
+        RebuildPath(L, S, W, [&](int big, int small) { return via.Get(states.index(big, small)); }, path);
+    }
+
+    result.solved = true;
+    result.operations = uint32_t(path.size());
+    result.moves = path;
+    return result;
+}
+
+/**
+ * @brief Runs A* from (0, 0) until (W, 0) is popped, generating neighbors on the fly.
+ *
+ * g is not stored: it is the key of the popped entry minus the state's estimate. Since h is
+ * consistent, the first entry popped for a state carries its shortest distance, and later
+ * entries for it are skipped.
+ */
+bool AStarSolver::Search(const StateIndex& states, int L, int S, int W, const Ring* ring, Result& result)
+{
+    SearchStats& stats = result.stats;
+    uint32_t start = states.index(0, 0);
+    uint32_t goal = states.index(W, 0);
+    auto estimate = [ring](int big, int small) { return ring ? ring->Estimate(uint64_t(big), uint64_t(small)) : 0; };
+
+    queue.Push(estimate(0, 0), start);
+    std::size_t queued = 1;
+
+    while (!queue.Empty())
+    {
+        uint64_t f;
+        uint64_t entry = queue.Pop(f);
+        queued--;
+        uint32_t U = uint32_t(entry);
+        if (closed.Test(U))     // stale entry, the state was popped with a shorter distance
+            continue;
+        closed.Set(U);
+        if (U != start)
+            via.Set(U, Move(entry >> 32));
+        if (U == goal)
+            return true;
+
+        auto [big, small] = states.state(U);
+        result.expanded++;
+        stats.Expand();
+        uint64_t through = f - estimate(big, small) + 1;
+
+        int toBig, toSmall;
+        for (int m = 0; m < MoveCount; m++)
+        {
+            if (!ApplyMove(Move(m), L, S, big, small, toBig, toSmall))
+                continue;
+
+            stats.Relax();
+            uint32_t V = states.index(toBig, toSmall);
+            if (!closed.Test(V))
+            {
+                queue.Push(through + estimate(toBig, toSmall), (uint64_t(m) << 32) | V);
+                queued++;
+            }
+        }
+        stats.Queue(queued);
+    }
+
+    return false;
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "Common.h"
+#include "JugSolver.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include "PackedArrays.h"
+#include "BucketQueue.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Reusable A* solver for the two-jug problem, for single queries on large capacities.
+ *
+ * A BFS expands every state closer to (0, 0) than the goal, in both directions around the
+ * state space. A* orders the states by g + h, where h is a lower bound on the operations
+ * still needed, so it follows the direction that leads to the goal and mostly leaves the
+ * other one alone.
+ *
+ * The bound comes from the modular structure of the problem. Apart from (0, 0), the reachable
+ * states form one ring: the sequence "fill L, pour L into S, empty S when full" (cycle A of
+ * Way3) visits each of them once before coming back to (L, 0), and cycle B walks the same ring
+ * backwards. A state's position on the ring is the number of operations cycle A takes to reach
+ * it, which follows from the amount poured so far and a modular inverse (see Ring). Every
+ * operation either moves one step along the ring or has an end at a corner (L, 0), (0, S),
+ * (L, S) or (0, 0). So a path either walks the ring, or passes through a corner and walks the
+ * ring from there:
+ *
+ *     h(X) = min(ring distance from X to the goal, [X not a corner] + min ring distance from a corner to the goal)
+ *
+ * is admissible and consistent. A state whose position cannot be derived this way (S = 0, or
+ * the goal (0, 0), which is off the ring) is searched with h = 0, i.e. as a BFS by levels.
+ * Targets that are not a multiple of gcd(L, S) are rejected without a search.
+ *
+ * With unit costs and a consistent h, f = g + h grows by 0 or 2 along every operation, so the
+ * queue is a BucketQueue of three buckets. Each entry carries the state and the operation that
+ * reached it; the first entry of a state to be popped is the final one (lazy deletion). Within
+ * a bucket the last entry pushed is popped first, which favors the deepest states among equal f.
+ */
+class AStarSolver
+{
+public:
+
+    /**
+     * @brief Outcome of one query, with how the search was guided.
+     */
+    struct Result : JugSolver::Result
+    {
+        bool informed = false;          ///< false if the search ran with h = 0 (BFS order)
+        uint64_t expanded = 0;          ///< States taken off the queue and expanded (always counted)
+    };
+
+    /**
+     * @brief Finds a shortest sequence of operations from (0, 0) to (W, 0).
+     *
+     * @param L Capacity of the large jug
+     * @param S Capacity of the small jug, 0 <= S < L
+     * @param W Target amount in the large jug
+     * @throws std::invalid_argument if the capacities are out of range
+     */
+    Result Solve(int L, int S, int W);
+
+    /**
+     * @brief Memory currently held by the scratch buffers, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        return closed.MemoryBytes() + via.MemoryBytes() + queue.MemoryBytes() + path.capacity() * sizeof(Move);
+    }
+
+private:
+
+    /**
+     * @brief Positions on the ring of reachable states and the heuristic derived from them.
+     *
+     * Cycle A starts at (L, 0), position 0. Let P be the total amount poured from L into S so
+     * far. Pours end exactly when P reaches a multiple of S (the small jug is full) or of L (the
+     * large jug is empty), and every such end is followed by one empty of S or one fill of L.
+     * The number of operations up to a state therefore only depends on P and on which of those
+     * operations already happened. For a state (b, s), P = -b (mod L) and P = s or 0 (mod S),
+     * which gives P in (0, lcm(L, S)] by the Chinese remainder theorem. The ring closes
+     * at P = lcm, with (0, S) -> (L, S) -> (L, 0).
+     */
+    class Ring
+    {
+    public:
+
+        /**
+         * @brief Prepares the heuristic towards (W, 0). Requires 0 < S < L and 0 < W <= L, W a multiple of gcd(L, S).
+         */
+        Ring(uint64_t _L, uint64_t _S, uint64_t W);
+
+        /**
+         * @brief Lower bound on the operations from a reachable state to (W, 0).
+         */
+        uint64_t Estimate(uint64_t big, uint64_t small) const
+        {
+            if (big == 0 && small == 0)
+                return hubDistance;
+
+            uint64_t distance = Distance(Position(big, small), goal);
+            return std::min(distance, hubDistance + (IsCorner(big, small) ? 0 : 1));
+        }
+
+    private:
+        uint64_t L, S;
+        uint64_t g;             ///< gcd(L, S)
+        uint64_t lcm;           ///< lcm(L, S): the amount poured in one turn of the ring
+        uint64_t Sg;            ///< S / g
+        uint64_t invLargeMod;   ///< Inverse of L/g modulo S/g
+        uint64_t fullSmall;     ///< Position of (0, S); (L, S) follows it
+        uint64_t length;        ///< Number of states on the ring
+        uint64_t goal;          ///< Position of (W, 0)
+        uint64_t hubDistance;   ///< Ring distance from the nearest corner to the goal
+
+        /**
+         * @brief Number of pours that end at a total amount poured in (0, P].
+         */
+        uint64_t Pours(uint64_t P) const { return P / S + P / L - P / lcm; }
+
+        /**
+         * @brief Position of a reachable state other than (0, 0) on the ring.
+         */
+        uint64_t Position(uint64_t big, uint64_t small) const;
+
+        /**
+         * @brief Operations between two positions, going the shorter way around the ring.
+         */
+        uint64_t Distance(uint64_t a, uint64_t b) const
+        {
+            uint64_t d = a > b ? a - b : b - a;
+            return std::min(d, length - d);
+        }
+
+        bool IsCorner(uint64_t big, uint64_t small) const
+        {
+            return (big == L && small == 0) || (big == 0 && small == S) || (big == L && small == S);
+        }
+    };
+
+    StampedBitmap closed;               ///< States expanded (or popped) by the current query
+    MoveArray via;                      ///< Operation that reached each closed state
+    BucketQueue<uint64_t> queue;        ///< Entries keyed by f: state index, and operation in bits 32-34
+    std::vector<Move> path;             ///< Moves of the last solution
+
+    /**
+     * @brief A* from (0, 0) over the pooled buffers.
+     *
+     * @param ring Heuristic, or nullptr to search with h = 0
+     * @return true if (W, 0) was reached
+     */
+    bool Search(const StateIndex& states, int L, int S, int W, const Ring* ring, Result& result);
+};
@@ -0,0 +1,568 @@
+#include "Batch.h"
+#include "Common.h"
+#include "TableCache.h"
+#include "WorkStealingPool.h"
+#include <charconv>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+
+/**
+ * @brief Parses a format name given on the command line.
+ */
+bool Batch::ParseFormat(const std::string& name, Format& format)
+{
+    if (name == "text") format = Format::Text;
+    else if (name == "csv") format = Format::Csv;
+    else if (name == "json") format = Format::Json;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Allocates the I/O buffers and writes the CSV header if needed.
+ */
+Batch::Batch(FILE* _in, FILE* _out, Format _format, bool _useTables, const std::string& _cacheDirectory,
+             unsigned _threads)
+    : in(_in), out(_out), format(_format), useTables(_useTables || !_cacheDirectory.empty()),
+      cacheDirectory(_cacheDirectory), threads(_threads), inBuf(BufferSize)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    outBuf.reserve(BufferSize + 256);
+
+    if (format == Format::Csv)
+        outBuf += "L,S,W,status,operations,line,input\n";
+}
+
+/**
+ * @brief Flushes any remaining output.
+ */
+Batch::~Batch()
+{
+    Flush();
+}
+
+/**
+ * @brief Returns the next input byte without consuming it, or EOF.
+ */
+int Batch::Peek()
+{
+    if (inPos == inLen)
+    {
+        inLen = std::fread(inBuf.data(), 1, inBuf.size(), in);
+        inPos = 0;
+        if (inLen == 0)
+            return EOF;
+    }
+    return (unsigned char)inBuf[inPos];
+}
+
+/**
+ * @brief Reads one line of input and parses it as three non-negative integers.
+ *
+ * Empty lines are skipped. Any other malformed line is reported as invalid,
+ * so that every query line gets exactly one result line. The first MaxEchoBytes
+ * bytes of the line are kept in lineText, for reporting an invalid line.
+ */
+bool Batch::ReadQuery(uint64_t values[3], bool& valid)
+{
+    int c;
+    auto consume = [&]
+    {
+        if (lineText.size() < MaxEchoBytes && c != '\r')
+            lineText += char(c);
+        inPos++;
+    };
+
+    // === Skip empty lines, counting them ===
+    while ((c = Peek()) == '\n' || c == '\r')
+    {
+        newlines += c == '\n';
+        inPos++;
+    }
+    if (c == EOF)
+        return false;
+
+    lineNumber = newlines + 1;
+    valid = true;
+    int count = 0;
+    lineText.clear();
+
+    // === Parse fields until the end of the line ===
+    while ((c = Peek()) != EOF && c != '\n')
+    {
+        if (c == ' ' || c == '\t' || c == ',' || c == '\r')
+        {
+            consume();
+            continue;
+        }
+
+        if (c < '0' || c > '9' || count == 3)
+        {
+            valid = false;
+            consume();
+            continue;
+        }
+
+        uint64_t value = 0;
+        while ((c = Peek()) >= '0' && c <= '9')
+        {
+            if (value > (UINT64_MAX - 9) / 10)
+                valid = false; // overflow
+            value = value * 10 + uint64_t(c - '0');
+            consume();
+        }
+        values[count++] = value;
+    }
+
+    if (count != 3)
+        valid = false;
+    return true;
+}
+
+/**
+ * @brief Returns the cached solver for (L, S), creating it on first use.
+ */
+const Way3& Batch::GetSolver(uint64_t L, uint64_t S)
+{
+    if (solvers.size() >= MaxSolvers)
+        solvers.clear();
+
+    return solvers.try_emplace({ L, S }, L, S).first->second;
+}
+
+/**
+ * @brief Returns the cached BFS table for (L, S), creating it on first use.
+ */
+const SolutionTable& Batch::GetTable(uint64_t L, uint64_t S)
+{
+    auto it = tables.find({ L, S });
+    if (it != tables.end())
+        return *it->second;
+
+    if (tables.size() >= MaxTables)
+        tables.clear();
+
+    auto table = std::make_unique<SolutionTable>(int(L), int(S));
+    return *tables.emplace(std::make_pair(L, S), std::move(table)).first->second;
+}
+
+/**
+ * @brief Returns the mapped table for (L, S), mapping it on first use.
+ */
+const SolutionCache& Batch::GetCache(uint64_t L, uint64_t S)
+{
+    auto it = caches.find({ L, S });
+    if (it != caches.end())
+        return *it->second;
+
+    if (caches.size() >= MaxTables)
+        caches.clear();
+
+    auto cache = std::make_unique<SolutionCache>(cacheDirectory, int(L), int(S));
+    return *caches.emplace(std::make_pair(L, S), std::move(cache)).first->second;
+}
+
+/**
+ * @brief Answers one query from the closed form or from the BFS table of its reduced jugs.
+ *
+ * A solver or table is charged to the query that creates it: its own stats are merged in
+ * (a SolutionCache keeps none, so its mapping or building is timed as the build phase).
+ */
+uint64_t Batch::Answer(uint64_t L, uint64_t S, uint64_t W, bool& solvable, SearchStats& stats)
+{
+    CanonicalQuery query = CanonicalQuery::Reduce(L, S, W);
+    solvable = query.solvable;
+    if (!solvable)
+        return 0;
+    L = query.L;
+    S = query.S;
+    W = query.W;
+
+    if (useTables && cacheDirectory.empty())
+    {
+        bool fresh = !tables.contains({ L, S });
+        const SolutionTable& table = GetTable(L, S);
+        if (fresh)
+            stats.Merge(table.Stats());
+
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        uint32_t operations = table.MinOperations(int(W));
+        solvable = operations != SolutionTable::Unreachable;
+        return operations;
+    }
+
+    if (useTables)
+    {
+        const SolutionCache* cache;
+        {
+            auto buildTimer = stats.Time(SearchPhase::Build);
+            cache = &GetCache(L, S);
+        }
+
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        uint32_t operations = cache->MinOperations(int(W));
+        solvable = operations != SolutionTable::Unreachable;
+        return operations;
+    }
+
+    bool fresh = !solvers.contains({ L, S });
+    const Way3& solver = GetSolver(L, S);
+    if (fresh)
+        stats.Merge(solver.Stats());
+
+    auto searchTimer = stats.Time(SearchPhase::Search);
+    solvable = solver.Solvable(W);
+    return solvable ? solver.CountOperations(W) : 0;
+}
+
+/**
+ * @brief Same validation as the interactive mode.
+ */
+bool Batch::Validate(const uint64_t values[3]) const
+{
+    uint64_t L = values[0], S = values[1], W = values[2];
+    return L > S && W <= L && L <= (useTables ? uint64_t(INT_MAX) : Way3::MaxCapacity);
+}
+
+/**
+ * @brief Reads and answers all queries.
+ */
+uint64_t Batch::Run()
+{
+    if (threads > 1)
+        return RunParallel();
+
+    uint64_t values[3];
+    bool valid;
+    uint64_t count = 0;
+
+    while (ReadQuery(values, valid))
+    {
+        count++;
+
+        bool solvable = false, tooLarge = false;
+        uint64_t operations = 0;
+        SearchStats stats;
+        valid = valid && Validate(values);
+        if (valid)
+        {
+            try
+            {
+                operations = Answer(values[0], values[1], values[2], solvable, stats);
+            }
+            catch (const std::exception&)
+            {
+                tooLarge = true;    // StateIndex cannot number the states, or the table could not be allocated
+            }
+        }
+
+        WriteResult(lineNumber, values, valid, solvable, tooLarge, operations, lineText, stats);
+
+        if (outBuf.size() >= BufferSize)
+            Flush();
+    }
+
+    Flush();
+    return count;
+}
+
+/**
+ * @brief Reads a chunk, groups its valid queries by reduced (L, S), queues one task per group and
+ * writes the answered prefix of the chunk each time a group completes.
+ *
+ * Tables built for a chunk stay in a TableCache shared by the workers, so a (L, S) that
+ * shows up again in a later chunk is not solved twice.
+ */
+uint64_t Batch::RunParallel()
+{
+    WorkStealingPool pool(threads);
+    TableCache tableCache(TableBudget);
+
+    std::vector<Query> queries;
+    std::vector<std::vector<uint32_t>> groups;  // query indices of each (L, S)
+    std::unordered_map<std::pair<uint64_t, uint64_t>, uint32_t, CapacityHash> groupIndex;
+    queries.reserve(ChunkQueries);
+
+    std::mutex doneMutex;                       // guards groupDone
+    std::condition_variable groupFinished;
+    std::vector<char> groupDone;
+
+    uint64_t count = 0;
+    bool more = true;
+
+    while (more)
+    {
+        // === Read and group one chunk ===
+        queries.clear();
+        groups.clear();
+        groupIndex.clear();
+
+        while (queries.size() < ChunkQueries)
+        {
+            Query query;
+            if (!(more = ReadQuery(query.values, query.valid)))
+                break;
+
+            query.valid = query.valid && Validate(query.values);
+            query.group = NoGroup;
+            query.tooLarge = false;
+            query.line = lineNumber;
+            if (!query.valid)
+                query.text = lineText;
+            if (query.valid)
+                query.reduced = CanonicalQuery::Reduce(query.values[0], query.values[1], query.values[2]);
+
+            if (query.valid && !query.reduced.solvable)
+            {
+                query.solvable = false;     // answered here, no task needed
+                query.operations = 0;
+            }
+            else if (query.valid)
+            {
+                auto [it, inserted] = groupIndex.try_emplace({ query.reduced.L, query.reduced.S }, uint32_t(groups.size()));
+                if (inserted)
+                    groups.emplace_back();
+                query.group = it->second;
+                groups[query.group].push_back(uint32_t(queries.size()));
+            }
+            queries.push_back(query);
+        }
+
+        groupDone.assign(groups.size(), 0);
+
+        // === One task per group: build the solver once, answer every W ===
+        for (uint32_t g = 0; g < groups.size(); g++)
+        {
+            pool.Submit([&, g]
+            {
+                const std::vector<uint32_t>& members = groups[g];
+                const uint64_t L = queries[members[0]].reduced.L;
+                const uint64_t S = queries[members[0]].reduced.S;
+
+                SearchStats& first = queries[members[0]].stats;  // charged for the solver or table
+                auto answerAll = [&](auto&& answer)
+                {
+                    for (uint32_t i : members)
+                    {
+                        auto searchTimer = queries[i].stats.Time(SearchPhase::Search);
+                        queries[i].operations = answer(queries[i].reduced.W, queries[i].solvable);
+                    }
+                };
+
+                try
+                {
+                    if (!cacheDirectory.empty())
+                    {
+                        std::optional<SolutionCache> table;
+                        {
+                            auto buildTimer = first.Time(SearchPhase::Build);
+                            table.emplace(cacheDirectory, int(L), int(S));
+                        }
+                        answerAll([&](uint64_t W, bool& solvable)
+                        {
+                            uint32_t operations = table->MinOperations(int(W));
+                            solvable = operations != SolutionTable::Unreachable;
+                            return uint64_t(operations);
+                        });
+                    }
+                    else if (useTables)
+                    {
+                        bool computed;
+                        TableCache::TablePtr table = tableCache.Get(int(L), int(S), &computed);
+                        if (computed)
+                            first.Merge(table->Stats());
+                        answerAll([&](uint64_t W, bool& solvable)
+                        {
+                            uint32_t operations = table->MinOperations(int(W));
+                            solvable = operations != SolutionTable::Unreachable;
+                            return uint64_t(operations);
+                        });
+                    }
+                    else
+                    {
+                        Way3 solver(L, S);
+                        first.Merge(solver.Stats());
+                        answerAll([&](uint64_t W, bool& solvable)
+                        {
+                            solvable = solver.Solvable(W);
+                            return solvable ? solver.CountOperations(W) : 0;
+                        });
+                    }
+                }
+                catch (...)
+                {
+                    // StateIndex cannot number the states, or the table could not be allocated
+                    for (uint32_t i : members)
+                        queries[i].tooLarge = true;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    groupDone[g] = 1;
+                }
+                groupFinished.notify_one();
+            });
+        }
+
+        // === Reorder buffer: write every query whose predecessors are all answered ===
+        std::size_t next = 0;
+        while (next < queries.size())
+        {
+            std::size_t end = next;
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                auto answered = [&](std::size_t i) { return queries[i].group == NoGroup || groupDone[queries[i].group]; };
+                groupFinished.wait(lock, [&] { return answered(next); });
+                while (end < queries.size() && answered(end))
+                    end++;
+            }
+
+            for (; next < end; next++)
+            {
+                const Query& query = queries[next];
+                WriteResult(query.line, query.values, query.valid, query.solvable, query.tooLarge, query.operations,
+                            query.text, query.stats);
+            }
+
+            if (outBuf.size() >= BufferSize)
+                Flush();
+        }
+
+        pool.Wait();    // the tasks of this chunk refer to its vectors
+
+        count += queries.size();
+    }
+
+    Flush();
+    return count;
+}
+
+/**
+ * @brief Appends one result line in the selected format.
+ */
+void Batch::WriteResult(uint64_t line, const uint64_t values[3], bool valid, bool solvable, bool tooLarge,
+                        uint64_t operations, const std::string& text, const SearchStats& stats)
+{
+    auto appendStats = [&]
+    {
+        if constexpr (SearchStats::Enabled)
+        {
+            outBuf += ",\"stats\":";
+            outBuf += stats.ToJson();
+        }
+    };
+
+    if (!valid)
+    {
+        switch (format)
+        {
+        case Format::Text: outBuf += "invalid query on line "; Append(line); outBuf += '\n'; break;
+        case Format::Csv:
+            outBuf += ",,,invalid,,"; Append(line);
+            outBuf += ",\"";
+            for (char c : text)     // quoted field: double every quote
+            {
+                if (c == '"')
+                    outBuf += '"';
+                outBuf += c;
+            }
+            outBuf += "\"\n";
+            break;
+        case Format::Json:
+            outBuf += "{\"status\":\"invalid\",\"line\":"; Append(line);
+            outBuf += ",\"input\":\"";
+            for (char c : text)     // JSON string: escape quotes, backslashes and every byte outside printable ASCII
+            {
+                unsigned char byte = (unsigned char)c;
+                if (c == '"' || c == '\\')
+                {
+                    outBuf += '\\';
+                    outBuf += c;
+                }
+                else if (byte < 0x20 || byte >= 0x7f)
+                {
+                    static const char hex[] = "0123456789abcdef";
+                    outBuf += "\\u00";
+                    outBuf += hex[byte >> 4];
+                    outBuf += hex[byte & 15];
+                }
+                else
+                    outBuf += c;
+            }
+            outBuf += '"';
+            appendStats();
+            outBuf += "}\n";
+            break;
+        }
+        return;
+    }
+
+    uint64_t L = values[0], S = values[1], W = values[2];
+    const char sep = (format == Format::Csv) ? ',' : ' ';
+
+    if (format == Format::Json)
+    {
+        outBuf += "{\"L\":"; Append(L);
+        outBuf += ",\"S\":"; Append(S);
+        outBuf += ",\"W\":"; Append(W);
+        if (tooLarge)
+            outBuf += ",\"status\":\"too-large\",\"operations\":null";
+        else if (solvable)
+        {
+            outBuf += ",\"status\":\"ok\",\"operations\":";
+            Append(operations);
+        }
+        else
+            outBuf += ",\"status\":\"no-solution\",\"operations\":null";
+        appendStats();
+        outBuf += "}\n";
+        return;
+    }
+
+    Append(L); outBuf += sep;
+    Append(S); outBuf += sep;
+    Append(W); outBuf += sep;
+
+    if (format == Format::Csv)
+        outBuf += tooLarge ? "too-large," : solvable ? "ok," : "no-solution,";
+
+    if (tooLarge)
+    {
+        if (format == Format::Text)
+            outBuf += "error too-large";
+    }
+    else if (solvable)
+        Append(operations);
+    else if (format == Format::Text)
+        outBuf += '-';
+    if (format == Format::Csv)
+        outBuf += ",,";     // no line or input: only invalid queries are echoed
+    outBuf += '\n';
+}
+
+/**
+ * @brief Appends the decimal digits of a value to the output buffer.
+ */
+void Batch::Append(uint64_t value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    outBuf.append(digits, result.ptr);
+}
+
+/**
+ * @brief Writes and clears the output buffer.
+ */
+void Batch::Flush()
+{
+    if (!outBuf.empty())
+    {
+        std::fwrite(outBuf.data(), 1, outBuf.size(), out);
+        outBuf.clear();
+    }
+    std::fflush(out);
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include "Common.h"
+#include "Way3.h"
+#include "SolutionTable.h"
+#include "SolutionCache.h"
+#include "CanonicalQuery.h"
+#include <cstdio>
+#include <memory>
+
+/**
+ * @brief Non-interactive batch mode: answers many (L, S, W) queries read from a file or pipe.
+ *
+ * Input is one query per line, "L S W" (spaces, tabs or commas between the numbers).
+ * Output is one line per query in the selected format, written in the same order.
+ * Both directions go through large buffers instead of prompts and per-line stream I/O,
+ * and queries that share (L, S) reuse one solver instance: a Way3 by default, or a
+ * SolutionTable (one complete BFS per (L, S)) when tables are requested, or a
+ * SolutionCache (the same table, mapped from a file shared across runs) when a cache
+ * directory is given. Each query is first reduced by gcd(L, S) (see CanonicalQuery): a
+ * target that is not a multiple is answered at once, and scaled copies of a jug pair share
+ * the solver of the reduced pair. A query whose table has more states than StateIndex can
+ * number, or does not fit in memory, gets a "too-large" row and the run goes on.
+ *
+ * With several threads, queries are read in chunks and grouped by (L, S); each group is one
+ * task on a WorkStealingPool that builds the solver once and answers all the group's W values.
+ * Results are written in input order through a reorder buffer: a query is written as soon as
+ * it and every query before it are answered.
+ *
+ * When JUG_STATS is set, every JSON row also carries a "stats" object (see SearchStats::ToJson)
+ * with the work spent on that query: its lookup as the search phase and, for the query that
+ * created its solver or table, the cost of creating it.
+ */
+class Batch
+{
+public:
+
+    /**
+     * @brief Output format of the result lines.
+     */
+    enum class Format
+    {
+        Text,   ///< "L S W operations", with "-" when there is no solution and "error too-large" as in Server
+        Csv,    ///< "L,S,W,status,operations,line,input" with a header line; line and input only for invalid queries
+        Json    ///< One JSON object per line; "line" and "input" only for invalid queries, as in CSV
+    };
+
+    /**
+     * @brief Parses a format name ("text", "csv" or "json").
+     *
+     * @param name The name given on the command line
+     * @param format Receives the format
+     * @return false if the name is not recognized
+     */
+    static bool ParseFormat(const std::string& name, Format& format);
+
+    /**
+     * @brief Prepares a batch run between two open streams.
+     *
+     * @param _in Stream the queries are read from
+     * @param _out Stream the results are written to
+     * @param _format Output format
+     * @param _useTables Answer with a BFS SolutionTable per (L, S) instead of Way3
+     * @param _cacheDirectory If not empty, answer with a SolutionCache per (L, S) from this directory
+     * @param _threads Number of solver threads (1 = solve on the calling thread, 0 = one per hardware thread)
+     */
+    Batch(FILE* _in, FILE* _out, Format _format, bool _useTables = false, const std::string& _cacheDirectory = "",
+          unsigned _threads = 1);
+
+    /**
+     * @brief Destructor - flushes any buffered output.
+     */
+    ~Batch();
+
+    /**
+     * @brief Reads and answers all queries until end of input.
+     *
+     * @return Number of queries answered
+     */
+    uint64_t Run();
+
+private:
+
+    /**
+     * @brief One query of a chunk in parallel mode, and its answer once its group is solved.
+     */
+    struct Query
+    {
+        uint64_t values[3];     ///< L, S and W as read
+        bool valid;             ///< Passed parsing and validation
+        CanonicalQuery reduced; ///< The query divided by gcd(L, S), if valid
+        bool solvable;          ///< (W, 0) is reachable
+        bool tooLarge;          ///< The table of the reduced (L, S) could not be built
+        uint64_t operations;    ///< Minimum number of operations, if solvable
+        uint32_t group;         ///< Index of the reduced (L, S) group, or NoGroup if answered without one
+        uint64_t line;          ///< Line number in the input, counting blank lines
+        std::string text;       ///< The input line, if not valid
+        SearchStats stats;      ///< Work spent on this query (empty unless JUG_STATS is set)
+    };
+
+    static constexpr uint32_t NoGroup = UINT32_MAX;     ///< Group of a query rejected by its reduction
+
+    /**
+     * @brief Hash for a pair of capacities, used to find the solver of a (L, S) pair.
+     */
+    struct CapacityHash
+    {
+        std::size_t operator()(const std::pair<uint64_t, uint64_t>& p) const
+        {
+            uint64_t h = p.first * 0x9E3779B97F4A7C15ull ^ (p.second + 0x632BE59BD9B4E019ull);
+            return std::size_t(h ^ (h >> 32));
+        }
+    };
+
+    static constexpr std::size_t BufferSize = 1 << 20;  ///< Size of the input and output buffers
+    static constexpr std::size_t MaxSolvers = 1 << 16;  ///< Solver cache is cleared beyond this size
+    static constexpr std::size_t MaxTables = 16;        ///< Table cache is cleared beyond this size
+    static constexpr std::size_t ChunkQueries = 1 << 16;///< Queries grouped together in parallel mode
+    static constexpr std::size_t MaxEchoBytes = 256;   ///< Bytes of an invalid line echoed in CSV output
+    static constexpr std::size_t TableBudget = std::size_t(1) << 30; ///< Bytes of tables kept across chunks in parallel mode
+
+    FILE* in;
+    FILE* out;
+    Format format;
+    bool useTables;
+    std::string cacheDirectory;     ///< Directory of SolutionCache files, or empty
+    unsigned threads;               ///< Number of solver threads
+
+    std::vector<char> inBuf;        ///< Input buffer
+    std::size_t inPos = 0;          ///< Next unread byte in inBuf
+    std::size_t inLen = 0;          ///< Number of valid bytes in inBuf
+    std::string outBuf;             ///< Output buffer, flushed when it grows past BufferSize
+    std::string lineText;           ///< Start of the line last read by ReadQuery
+    uint64_t newlines = 0;          ///< Line breaks read so far
+    uint64_t lineNumber = 0;        ///< Line number (from 1) of the line last read by ReadQuery
+
+    std::unordered_map<std::pair<uint64_t, uint64_t>, Way3, CapacityHash> solvers; ///< One solver per (L, S)
+    std::unordered_map<std::pair<uint64_t, uint64_t>, std::unique_ptr<SolutionTable>, CapacityHash> tables; ///< One table per (L, S)
+    std::unordered_map<std::pair<uint64_t, uint64_t>, std::unique_ptr<SolutionCache>, CapacityHash> caches; ///< One mapped table per (L, S)
+
+    /**
+     * @brief Returns the next input byte, or EOF, refilling the buffer as needed.
+     */
+    int Peek();
+
+    /**
+     * @brief Reads one query line.
+     *
+     * @param values Receives L, S and W
+     * @param valid Set to false if the line does not hold exactly three non-negative integers
+     * @return false at end of input
+     */
+    bool ReadQuery(uint64_t values[3], bool& valid);
+
+    /**
+     * @brief Returns the solver for (L, S), creating it on first use.
+     */
+    const Way3& GetSolver(uint64_t L, uint64_t S);
+
+    /**
+     * @brief Returns the BFS table for (L, S), creating it on first use.
+     */
+    const SolutionTable& GetTable(uint64_t L, uint64_t S);
+
+    /**
+     * @brief Returns the mapped table for (L, S), mapping (or building) its file on first use.
+     */
+    const SolutionCache& GetCache(uint64_t L, uint64_t S);
+
+    /**
+     * @brief Answers one validated query with the selected engine, after reducing it by gcd(L, S).
+     *
+     * @param solvable Set to true if (W, 0) is reachable
+     * @param stats Receives the lookup time, and the cost of the solver or table if this query created it
+     * @return Minimum number of operations, if solvable
+     */
+    uint64_t Answer(uint64_t L, uint64_t S, uint64_t W, bool& solvable, SearchStats& stats);
+
+    /**
+     * @brief Validates a parsed query against the limits of the selected engine.
+     */
+    bool Validate(const uint64_t values[3]) const;
+
+    /**
+     * @brief Answers all queries on a WorkStealingPool, one task per (L, S) of each chunk.
+     *
+     * @return Number of queries answered
+     */
+    uint64_t RunParallel();
+
+    /**
+     * @brief Formats the result of one query into the output buffer.
+     *
+     * @param solvable Set if (W, 0) is reachable (ignored for invalid queries)
+     * @param tooLarge Set if the query's table could not be built (ignored for invalid queries)
+     * @param operations Minimum number of operations, if solvable
+     * @param line Line number of the query in the input, for an invalid query
+     * @param text The input line, echoed for an invalid query
+     * @param stats Work spent on the query, added to JSON rows when JUG_STATS is set
+     */
+    void WriteResult(uint64_t line, const uint64_t values[3], bool valid, bool solvable, bool tooLarge,
+                     uint64_t operations, const std::string& text, const SearchStats& stats);
+
+    /**
+     * @brief Appends an unsigned integer to the output buffer.
+     */
+    void Append(uint64_t value);
+
+    /**
+     * @brief Writes the output buffer to the output stream.
+     */
+    void Flush();
+};
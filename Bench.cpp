@@ -0,0 +1,316 @@
+#include "Way1.h"
+#include "Way2.h"
+#include "Way3.h"
+#include "Way4.h"
+#include "Way5.h"
+#include "JugSolver.h"
+#include "WeightedSolver.h"
+#include "AStarSolver.h"
+#include "BitsetSolver.h"
+#include "ExternalBfs.h"
+#include "Common.h"
+#include <cstring>
+#include <optional>
+using namespace std;
+
+/**
+ * @brief Benchmark driver comparing the solving engines across capacity scales.
+ *
+ * Usage: Bench [--reps N] [--warmup N] [--max-capacity L] [--engines way1,way2,...] [--format csv|json]
+ *
+ * Every engine runs every case `warmup` times untimed and `reps` times timed, without printing.
+ * For each phase the median and 99th percentile (nearest rank) are reported in nanoseconds.
+ * Way1 reports its graph build, search, path reconstruction and teardown separately, Way2 its search
+ * and path reconstruction; every engine also reports its total wall time.
+ */
+
+// === Cases ===
+
+/**
+ * @brief One benchmark query.
+ */
+struct Case
+{
+    string name;    ///< Scale and kind, e.g. "1e6-gcd1"
+    int L, S, W;    ///< Query
+};
+
+/**
+ * @brief Greatest common divisor.
+ */
+static int Gcd(int a, int b)
+{
+    while (b != 0)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief Builds the sweep: for each scale, a coprime pair, a pair with gcd 3, and an unsolvable target.
+ *
+ * The unsolvable case makes every engine explore the whole reachable state space.
+ */
+static vector<Case> MakeCases(int maxCapacity)
+{
+    vector<Case> cases;
+    const pair<const char*, int> scales[] = {
+        { "1e1", 10 }, { "1e3", 1000 }, { "1e5", 100000 }, { "1e6", 1000000 }, { "4e6", 4000000 } };
+
+    for (auto [scale, L] : scales)
+    {
+        if (L > maxCapacity)
+            break;
+
+        // gcd(L, S) = 1: every W in [0, L] is solvable
+        int S = L * 3 / 5;
+        while (Gcd(L, S) != 1)
+            S--;
+        cases.push_back({ string(scale) + "-gcd1", L, S, L / 3 });
+
+        // gcd(L, S) = 3: only multiples of 3 are solvable
+        int L3 = L - L % 3;
+        int S3 = (L3 * 3 / 5) / 3 * 3;
+        while (Gcd(L3, S3) != 3)
+            S3 -= 3;
+        cases.push_back({ string(scale) + "-gcd3", L3, S3, L3 / 3 / 3 * 3 });
+        cases.push_back({ string(scale) + "-unsolvable", L3, S3, L3 / 3 / 3 * 3 + 1 });
+    }
+    return cases;
+}
+
+// === Engines ===
+
+static const char* const EngineNames[] = { "way1", "way2", "way3", "way4", "way5", "solver", "weighted", "dial", "astar", "bitset", "external" };
+
+/**
+ * @brief The reusable solvers, shared by all runs so their buffers stay warm as a long-running service's would.
+ *
+ * "weighted" uses unit costs (0-1 BFS), "dial" charges 2 for the tap and the drain and 1 for a
+ * pour (bucket queue); both can be compared with the plain BFS of "solver", as can the A* of "astar"
+ * the word-parallel BFS of "bitset" and the disk-backed BFS of "external".
+ */
+struct Solvers
+{
+    JugSolver solver;
+    WeightedSolver weighted;
+    WeightedSolver dial{ CostModel{ { 2, 2, 2, 2, 1, 1 } } };
+    AStarSolver astar;
+    BitsetSolver bitset;
+    ExternalBfs external;
+};
+
+/**
+ * @brief Phase durations of one run, in nanoseconds; -1 for a phase the engine does not have.
+ */
+struct Sample
+{
+    long long build = -1, search = -1, path = -1, teardown = -1, total = -1;
+};
+
+static const char* const PhaseNames[] = { "build", "search", "path", "teardown", "total" };
+static constexpr int PhaseCount = 5;
+
+/**
+ * @brief Returns the duration of one phase of a sample.
+ */
+static long long Phase(const Sample& sample, int phase)
+{
+    switch (phase)
+    {
+    case 0: return sample.build;
+    case 1: return sample.search;
+    case 2: return sample.path;
+    case 3: return sample.teardown;
+    default: return sample.total;
+    }
+}
+
+/**
+ * @brief Runs one engine once on one case, without printing, and times its phases.
+ */
+static Sample RunOnce(const string& engine, const Case& c, Solvers& solvers)
+{
+    Sample sample;
+    auto start = chrono::steady_clock::now();
+
+    if (engine == "way1")
+    {
+        optional<Way1> way(in_place, c.L, c.S, c.W, false);
+        sample.build = way->BuildNanoseconds();
+        sample.search = way->SearchNanoseconds();
+        sample.path = way->PathNanoseconds();
+
+        auto teardownStart = chrono::steady_clock::now();
+        way.reset();    // releases the graph
+        sample.teardown = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - teardownStart).count();
+    }
+    else if (engine == "way2")
+    {
+        Way2 way(c.L, c.S, c.W, false);
+        sample.search = way.SearchNanoseconds();
+        sample.path = way.PathNanoseconds();
+    }
+    else if (engine == "way3")
+    {
+        Way3 way(c.L, c.S);
+        volatile uint64_t operations = way.Solvable(c.W) ? way.CountOperations(c.W) : 0;  // keep the call
+        (void)operations;
+    }
+    else if (engine == "way4")
+        Way4(c.L, c.S, c.W, false);
+    else if (engine == "way5")
+        Way5(c.L, c.S, c.W, false);
+    else if (engine == "solver")
+        solvers.solver.Solve(c.L, c.S, c.W);
+    else if (engine == "weighted")
+        solvers.weighted.Solve(c.L, c.S, c.W);
+    else if (engine == "dial")
+        solvers.dial.Solve(c.L, c.S, c.W);
+    else if (engine == "astar")
+        solvers.astar.Solve(c.L, c.S, c.W);
+    else if (engine == "bitset")
+        solvers.bitset.Solve(c.L, c.S, c.W);
+    else if (engine == "external")
+        solvers.external.Solve(c.L, c.S, c.W);
+
+    sample.total = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    return sample;
+}
+
+// === Statistics and output ===
+
+/**
+ * @brief Returns the value at the given percentile (nearest rank) of a sorted, non-empty list.
+ */
+static long long Percentile(const vector<long long>& sorted, int percent)
+{
+    size_t rank = (sorted.size() * percent + 99) / 100;    // ceil(n * p / 100)
+    return sorted[max<size_t>(rank, 1) - 1];
+}
+
+/**
+ * @brief Prints one result row in the chosen format.
+ */
+static void PrintRow(bool json, bool& first, const string& engine, const Case& c, const char* phase,
+    size_t reps, long long median, long long p99)
+{
+    if (json)
+    {
+        cout << (first ? "[\n" : ",\n")
+            << "  {\"engine\":\"" << engine << "\",\"case\":\"" << c.name
+            << "\",\"L\":" << c.L << ",\"S\":" << c.S << ",\"W\":" << c.W
+            << ",\"phase\":\"" << phase << "\",\"reps\":" << reps
+            << ",\"median_ns\":" << median << ",\"p99_ns\":" << p99 << "}";
+    }
+    else
+    {
+        if (first)
+            cout << "engine,case,L,S,W,phase,reps,median_ns,p99_ns\n";
+        cout << engine << "," << c.name << "," << c.L << "," << c.S << "," << c.W << ","
+            << phase << "," << reps << "," << median << "," << p99 << "\n";
+    }
+    first = false;
+}
+
+/**
+ * @brief Splits a comma-separated list.
+ */
+static vector<string> SplitList(const string& list)
+{
+    vector<string> items;
+    size_t begin = 0;
+    while (begin <= list.size())
+    {
+        size_t end = list.find(',', begin);
+        if (end == string::npos)
+            end = list.size();
+        if (end > begin)
+            items.push_back(list.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return items;
+}
+
+/**
+ * @brief Entry point of the benchmark executable.
+ */
+int main(int argc, char* argv[])
+{
+    int reps = 9, warmup = 1, maxCapacity = 1000000;
+    bool json = false;
+    vector<string> engines(begin(EngineNames), end(EngineNames));
+
+    // === Parse arguments ===
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--reps" && hasValue)
+            reps = max(1, atoi(argv[++i]));
+        else if (arg == "--warmup" && hasValue)
+            warmup = max(0, atoi(argv[++i]));
+        else if (arg == "--max-capacity" && hasValue)
+            maxCapacity = atoi(argv[++i]);
+        else if (arg == "--engines" && hasValue)
+            engines = SplitList(argv[++i]);
+        else if (arg == "--format" && hasValue && (!strcmp(argv[i + 1], "csv") || !strcmp(argv[i + 1], "json")))
+            json = !strcmp(argv[++i], "json");
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--reps N] [--warmup N] [--max-capacity L]"
+                << " [--engines way1,way2,way3,way4,way5,solver,weighted,dial,astar,bitset,external] [--format csv|json]" << endl;
+            return 1;
+        }
+    }
+
+    for (const string& engine : engines)
+    {
+        if (find(begin(EngineNames), end(EngineNames), engine) == end(EngineNames))
+        {
+            cerr << "Unknown engine " << engine << "." << endl;
+            return 1;
+        }
+    }
+
+    vector<Case> cases = MakeCases(maxCapacity);
+    Solvers solvers;
+    bool first = true;
+
+    // === Run every engine on every case ===
+    for (const string& engine : engines)
+    {
+        for (const Case& c : cases)
+        {
+            for (int i = 0; i < warmup; i++)
+                RunOnce(engine, c, solvers);
+
+            vector<Sample> samples;
+            for (int i = 0; i < reps; i++)
+                samples.push_back(RunOnce(engine, c, solvers));
+
+            for (int phase = 0; phase < PhaseCount; phase++)
+            {
+                if (Phase(samples[0], phase) < 0)
+                    continue; // engine does not have this phase
+
+                vector<long long> times;
+                for (const Sample& sample : samples)
+                    times.push_back(Phase(sample, phase));
+                sort(times.begin(), times.end());
+
+                PrintRow(json, first, engine, c, PhaseNames[phase], times.size(),
+                    Percentile(times, 50), Percentile(times, 99));
+            }
+            cout.flush();
+        }
+    }
+
+    if (json)
+        cout << (first ? "[]\n" : "\n]\n");
+    return 0;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include "Common.h"
+
+/**
+ * @brief Unsigned integer of unbounded size, for counting paths without overflow.
+ *
+ * The value is stored little-endian in 64-bit limbs. The lowest limb lives in the object and
+ * only the higher ones go to the heap, so a count below 2^64 never allocates and adding two
+ * of them costs one add and a carry test. Only addition is supported.
+ */
+class BigCount
+{
+public:
+
+    BigCount(uint64_t value = 0) : low(value) {}
+
+    /**
+     * @brief Adds another count to this one.
+     */
+    BigCount& operator+=(const BigCount& other)
+    {
+        uint64_t carry = AddWithCarry(low, other.low, 0);
+        if (other.high.size() > high.size())
+            high.resize(other.high.size(), 0);
+        for (std::size_t i = 0; i < high.size() && (carry != 0 || i < other.high.size()); i++)
+            carry = AddWithCarry(high[i], i < other.high.size() ? other.high[i] : 0, carry);
+        if (carry != 0)
+            high.push_back(carry);
+        return *this;
+    }
+
+    bool operator==(const BigCount& other) const = default;
+
+    /**
+     * @brief Returns true if the value fits in 64 bits, i.e. Low() is the whole value.
+     */
+    bool FitsUint64() const { return high.empty(); }
+
+    /**
+     * @brief The value modulo 2^64.
+     */
+    uint64_t Low() const { return low; }
+
+    /**
+     * @brief The value in decimal.
+     */
+    std::string ToString() const
+    {
+        // Split the limbs into 32-bit digits (most significant first) and divide by 10^9 until zero
+        std::vector<uint32_t> digits;
+        for (std::size_t i = high.size(); i-- > 0;)
+        {
+            digits.push_back(uint32_t(high[i] >> 32));
+            digits.push_back(uint32_t(high[i]));
+        }
+        digits.push_back(uint32_t(low >> 32));
+        digits.push_back(uint32_t(low));
+
+        std::vector<uint32_t> groups;   // base-10^9 digits, least significant first
+        std::size_t first = 0;
+        do
+        {
+            uint64_t remainder = 0;
+            for (std::size_t i = first; i < digits.size(); i++)
+            {
+                uint64_t value = (remainder << 32) | digits[i];
+                digits[i] = uint32_t(value / 1000000000);
+                remainder = value % 1000000000;
+            }
+            groups.push_back(uint32_t(remainder));
+            while (first < digits.size() && digits[first] == 0)
+                first++;
+        } while (first < digits.size());
+
+        std::string text = std::to_string(groups.back());
+        for (std::size_t i = groups.size() - 1; i-- > 0;)
+        {
+            std::string group = std::to_string(groups[i]);
+            text.append(9 - group.size(), '0');
+            text += group;
+        }
+        return text;
+    }
+
+    /**
+     * @brief Heap memory held by the higher limbs, in bytes.
+     */
+    std::size_t MemoryBytes() const { return high.capacity() * sizeof(uint64_t); }
+
+private:
+    uint64_t low;                   ///< Limb 0
+    std::vector<uint64_t> high;     ///< Limbs 1, 2, ...; empty while the value fits in 64 bits, no leading zero limb
+
+    /**
+     * @brief a += b + carry, returning the carry out (0 or 1).
+     */
+    static uint64_t AddWithCarry(uint64_t& a, uint64_t b, uint64_t carry)
+    {
+        uint64_t sum = a + b;
+        uint64_t out = sum < b;
+        sum += carry;
+        out += sum < carry;
+        a = sum;
+        return out;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const BigCount& count)
+{
+    return out << count.ToString();
+}
@@ -0,0 +1,248 @@
+#include "BitsetSolver.h"
+#include "Common.h"
+#include <bit>
+
+/**
+ * @brief Bits of word `word` whose positions lie in [lo, hi] (none if lo > hi).
+ */
+static uint64_t RangeMask(std::size_t word, int64_t lo, int64_t hi)
+{
+    int64_t first = int64_t(word) * 64;
+    lo = std::max(lo, first);
+    hi = std::min(hi, first + 63);
+    if (lo > hi)
+        return 0;
+
+    uint64_t width = uint64_t(hi - lo + 1);
+    uint64_t ones = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    return ones << (lo - first);
+}
+
+/**
+ * @brief Prepares the pooled buffers, then runs the search and rebuilds the path.
+ */
+BitsetSolver::Result BitsetSolver::Solve(int L, int S, int W)
+{
+    if (S < 0 || L <= S)
+        throw std::invalid_argument("BitsetSolver: capacities must satisfy 0 <= S < L");
+
+    Result result;
+    if (W < 0 || W > L)
+        return result;
+
+    SearchStats& stats = result.stats;
+    StateIndex states(L, S);
+    Prepare(states, L, S, stats);
+
+    bool found;
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        found = Search(states, L, S, W, stats);
+    }
+    if (!found)
+        return result;
+
+    {
+        auto pathTimer = stats.Time(SearchPhase::Path);
+        // The corners are all reached within two levels, from the states InverseMove assumes
+        RebuildPath(L, S, W, [&](int big, int small) { return via.Get(states.index(big, small)); }, path);
+    }
+
+    result.solved = true;
+    result.operations = uint32_t(path.size());
+    result.moves = path;
+    return result;
+}
+
+/**
+ * @brief Lends the caller's move array to the search in place of `via`, and records distances as well.
+ */
+void BitsetSolver::Sweep(int L, int S, std::span<uint32_t> dist, MoveArray& moves, SearchStats& stats)
+{
+    if (S < 0 || L <= S)
+        throw std::invalid_argument("BitsetSolver: capacities must satisfy 0 <= S < L");
+
+    StateIndex states(L, S);
+    std::swap(via, moves);      // before Prepare, so that the planes' own array is not grown
+    Prepare(states, L, S, stats);
+    dist[states.index(0, 0)] = 0;
+
+    sweepDist = dist.data();
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        Search(states, L, S, -1, stats);
+    }
+    sweepDist = nullptr;
+    std::swap(via, moves);
+}
+
+/**
+ * @brief Sizes the planes to the rows and columns of (L, S) and clears them.
+ */
+void BitsetSolver::Prepare(const StateIndex& states, int L, int S, SearchStats& stats)
+{
+    auto buildTimer = stats.Time(SearchPhase::Build);
+    std::size_t before = MemoryBytes();
+    for (int id = 0; id < PlaneCount; id++)
+    {
+        Plane& plane = planes[id];
+        std::size_t words = ((id == Empty || id == Full) ? std::size_t(L) : std::size_t(S)) / 64 + 1;
+        plane.visited.assign(words, 0);
+        plane.levels[0].assign(words, 0);
+        plane.levels[1].assign(words, 0);
+    }
+    levelWords[0].clear();
+    levelWords[1].clear();
+    via.Reserve(states.size());
+    stats.Allocate(MemoryBytes() - before);
+}
+
+/**
+ * @brief Expands the frontier one level at a time until (W, 0) is visited or the frontier is empty.
+ *
+ * For each non-empty frontier word, the operations that apply to its plane are carried out on all
+ * of its states at once; see the table in the class comment. Operations that cannot change a
+ * state (filling a full jug, pouring into a full one...) are either masked out or land on states
+ * that are already visited.
+ */
+bool BitsetSolver::Search(const StateIndex& states, int L, int S, int W, SearchStats& stats)
+{
+    if (W == 0)
+        return true;
+    if (S == 0)     // the rows coincide: only (0, 0) and (L, 0) are reachable
+    {
+        via.Set(states.index(L, 0), Move::FillLarge);
+        if (sweepDist)
+            sweepDist[states.index(L, 0)] = 1;
+        return W == L;
+    }
+
+    // === Start from (0, 0) ===
+    planes[Empty].visited[0] = 1;
+    planes[Empty].levels[0][0] = 1;
+    levelWords[0].push_back(Empty);
+
+    const std::size_t goalWord = std::size_t(W) >> 6;
+    const uint64_t goalBit = uint64_t(1) << (W & 63);
+
+    for (int level = 0; !levelWords[level & 1].empty(); level++)
+    {
+        // Sending a whole row or column onto a corner only matters until the corners are visited, at level 2
+        const bool corners = level < 2;
+        const int current = level & 1;
+        next = current ^ 1;
+        depth = uint32_t(level + 1);
+
+        for (uint32_t entry : levelWords[current])
+        {
+            std::size_t w = entry / PlaneCount;
+            uint64_t& word = planes[entry % PlaneCount].levels[current][w];
+            uint64_t x = word;
+            word = 0;   // leaves the level array clear for level + 2
+            stats.Expand(std::popcount(x));
+
+            switch (entry % PlaneCount)
+            {
+            case Empty:     // (b, 0)
+                if (corners)
+                {
+                    MergeState(states, L, S, Empty, L, Move::FillLarge);
+                    MergeState(states, L, S, Empty, 0, Move::EmptyLarge);
+                }
+                Transfer(states, L, S, Full, w, x, 0, Move::FillSmall);
+                Transfer(states, L, S, Full, w, x & RangeMask(w, S, L), -S, Move::PourLargeToSmall);          // (b - S, S)
+                Transfer(states, L, S, LargeEmpty, w, x & RangeMask(w, 1, S - 1), 0, Move::PourLargeToSmall); // (0, b)
+                break;
+
+            case Full:      // (b, S)
+                if (corners)
+                {
+                    MergeState(states, L, S, Full, L, Move::FillLarge);
+                    MergeState(states, L, S, Full, 0, Move::EmptyLarge);
+                }
+                Transfer(states, L, S, Empty, w, x, 0, Move::EmptySmall);
+                Transfer(states, L, S, Empty, w, x & RangeMask(w, 0, L - S), S, Move::PourSmallToLarge);                 // (b + S, 0)
+                Transfer(states, L, S, LargeFull, w, x & RangeMask(w, L - S + 1, L - 1), S - L, Move::PourSmallToLarge); // (L, b + S - L)
+                break;
+
+            case LargeEmpty:    // (0, s)
+                if (corners)
+                {
+                    MergeState(states, L, S, Full, 0, Move::FillSmall);
+                    MergeState(states, L, S, Empty, 0, Move::EmptySmall);
+                }
+                Transfer(states, L, S, LargeFull, w, x, 0, Move::FillLarge);
+                Transfer(states, L, S, Empty, w, x, 0, Move::PourSmallToLarge);     // (s, 0)
+                break;
+
+            default:        // (L, s)
+                if (corners)
+                {
+                    MergeState(states, L, S, Full, L, Move::FillSmall);
+                    MergeState(states, L, S, Empty, L, Move::EmptySmall);
+                }
+                Transfer(states, L, S, LargeEmpty, w, x, 0, Move::EmptyLarge);
+                Transfer(states, L, S, Full, w, x, L - S, Move::PourLargeToSmall);  // (L - S + s, S)
+                break;
+            }
+        }
+
+        if (W > 0 && (planes[Empty].visited[goalWord] & goalBit))
+            return true;
+
+        levelWords[current].clear();
+        stats.Queue(levelWords[next].size());
+    }
+
+    return false;
+}
+
+/**
+ * @brief AND-NOT against the visited bits; the new states join the next frontier and get their operation recorded.
+ */
+void BitsetSolver::Merge(const StateIndex& states, int L, int S, PlaneId to, std::size_t word, uint64_t bits, Move move)
+{
+    Plane& plane = planes[to];
+    uint64_t fresh = bits & ~plane.visited[word];
+    if (fresh == 0)
+        return;
+
+    plane.visited[word] |= fresh;
+    uint64_t& level = plane.levels[next][word];
+    if (level == 0)
+        levelWords[next].push_back(uint32_t(word * PlaneCount + to));
+    level |= fresh;
+
+    for (; fresh != 0; fresh &= fresh - 1)
+    {
+        int b = int(word * 64) + std::countr_zero(fresh);
+        uint32_t v = to == Empty ? states.index(b, 0)
+            : to == Full ? states.index(b, S)
+            : to == LargeEmpty ? states.index(0, b)
+            : states.index(L, b);
+        via.Set(v, move);
+        if (sweepDist)
+            sweepDist[v] = depth;
+    }
+}
+
+/**
+ * @brief Splits the shifted word over the (at most two) target words it straddles.
+ *
+ * The source bits are masked so that every target position is valid; a target word before
+ * the start of the plane therefore receives no bits.
+ */
+void BitsetSolver::Transfer(const StateIndex& states, int L, int S, PlaneId to, std::size_t word, uint64_t bits, int64_t shift, Move move)
+{
+    if (bits == 0)
+        return;
+
+    int64_t base = int64_t(word) * 64 + shift;
+    int64_t target = base >= 0 ? base / 64 : -((63 - base) / 64);    // floor(base / 64)
+    int offset = int(base - target * 64);
+
+    if (target >= 0)
+        Merge(states, L, S, to, std::size_t(target), bits << offset, move);
+    if (offset != 0 && (bits >> (64 - offset)) != 0)
+        Merge(states, L, S, to, std::size_t(target + 1), bits >> (64 - offset), move);
+}
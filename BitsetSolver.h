@@ -0,0 +1,133 @@
+#pragma once
+#include "Common.h"
+#include "JugSolver.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include "PackedArrays.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Reusable level-synchronous BFS for the two-jug problem that works on 64 states at a time.
+ *
+ * The boundary states are kept in four bit planes: the rows (b, 0) and (b, S) indexed by b, and
+ * the columns (0, s) and (L, s) indexed by s (corners belong to the rows). On these planes every
+ * operation is a whole-word transfer:
+ * - filling or emptying the small jug copies a row onto the other row, and filling or emptying
+ *   the large jug copies a column onto the other column;
+ * - a pour moves states along an anti-diagonal (big + small stays constant), which is a shift
+ *   by S between the rows, or a shift onto a column where the pour ends at an edge;
+ * - every other operation sends a whole row or column onto one corner.
+ *
+ * A level is computed from the words of the frontier that hold at least one state: each word is
+ * masked to the states an operation applies to, shifted into its target plane, and merged with an
+ * AND-NOT against the visited bits. Only the states that are new are looked at one by one, to
+ * record the operation that reached them (3 bits each, as in JugSolver) and to rebuild the path.
+ *
+ * The frontier is kept as a list of non-empty words rather than scanned in full: the reachable
+ * states form a single ring (see AStarSolver), so a level holds only a few states, and a pass
+ * over whole planes per level would cost O(n / 64) for each of O(n) levels.
+ */
+class BitsetSolver
+{
+public:
+
+    using Result = JugSolver::Result;  ///< Outcome of one query
+
+    /**
+     * @brief Finds a shortest sequence of operations from (0, 0) to (W, 0).
+     *
+     * @param L Capacity of the large jug
+     * @param S Capacity of the small jug, 0 <= S < L
+     * @param W Target amount in the large jug
+     * @throws std::invalid_argument if the capacities are out of range
+     */
+    Result Solve(int L, int S, int W);
+
+    /**
+     * @brief Runs the search from (0, 0) over every reachable state, for all targets at once.
+     *
+     * This is the sweep SolutionTable is built with: it records the distance and the operation
+     * of every state, and never looks for a goal.
+     *
+     * @param L Capacity of the large jug
+     * @param S Capacity of the small jug, 0 <= S < L
+     * @param dist Receives the distance of every reachable state, by StateIndex; must hold
+     *             StateIndex(L, S).size() entries, and unreachable states keep their value
+     * @param moves Receives the operation that reached every state; must hold as many entries
+     * @param stats Receives the counters and phase times of the sweep
+     */
+    void Sweep(int L, int S, std::span<uint32_t> dist, MoveArray& moves, SearchStats& stats);
+
+    /**
+     * @brief Memory currently held by the scratch buffers, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        std::size_t bytes = via.MemoryBytes() + path.capacity() * sizeof(Move);
+        for (const Plane& plane : planes)
+            bytes += (plane.visited.capacity() + plane.levels[0].capacity() + plane.levels[1].capacity()) * sizeof(uint64_t);
+        return bytes + (levelWords[0].capacity() + levelWords[1].capacity()) * sizeof(uint32_t);
+    }
+
+private:
+
+    /**
+     * @brief The four sets of boundary states.
+     */
+    enum PlaneId
+    {
+        Empty,      ///< (b, 0), b in [0, L]
+        Full,       ///< (b, S), b in [0, L]
+        LargeEmpty, ///< (0, s), s in (0, S)
+        LargeFull,  ///< (L, s), s in (0, S)
+        PlaneCount
+    };
+
+    /**
+     * @brief Bits of one set of states.
+     */
+    struct Plane
+    {
+        std::vector<uint64_t> visited;
+        std::vector<uint64_t> levels[2];    ///< States of even and odd levels: the frontier and the next frontier
+    };
+
+    Plane planes[PlaneCount];
+    std::vector<uint32_t> levelWords[2];    ///< Non-zero words of levels[0] and levels[1], as word * PlaneCount + plane
+    int next = 1;                           ///< Level parity being filled
+    uint32_t* sweepDist = nullptr;          ///< Distances recorded by Sweep, or null for Solve
+    uint32_t depth = 0;                     ///< Distance of the states of the level being filled
+    MoveArray via;                  ///< Operation that reached each visited state, by StateIndex
+    std::vector<Move> path;         ///< Moves of the last solution
+
+    /**
+     * @brief Sizes and clears the planes for (L, S), allocating only if a plane is a new maximum.
+     */
+    void Prepare(const StateIndex& states, int L, int S, SearchStats& stats);
+
+    /**
+     * @brief Level-synchronous BFS from (0, 0), stopping at the level that reaches (W, 0).
+     *
+     * @param W Target amount, or -1 to visit every reachable state
+     * @return true if (W, 0) was reached
+     */
+    bool Search(const StateIndex& states, int L, int S, int W, SearchStats& stats);
+
+    /**
+     * @brief Adds to the next frontier the states of `bits` (word `word` of plane `to`) that were not visited yet.
+     */
+    void Merge(const StateIndex& states, int L, int S, PlaneId to, std::size_t word, uint64_t bits, Move move);
+
+    /**
+     * @brief Moves the states of `bits`, the word `word` of a source plane, `shift` positions into plane `to`.
+     */
+    void Transfer(const StateIndex& states, int L, int S, PlaneId to, std::size_t word, uint64_t bits, int64_t shift, Move move);
+
+    /**
+     * @brief Adds the single state `bit` of plane `to` to the next frontier, if not visited yet.
+     */
+    void MergeState(const StateIndex& states, int L, int S, PlaneId to, std::size_t bit, Move move)
+    {
+        Merge(states, L, S, to, bit >> 6, uint64_t(1) << (bit & 63), move);
+    }
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include "Common.h"
+#include <bit>
+
+/**
+ * @brief Monotone priority queue for small integer edge costs (Dial's algorithm).
+ *
+ * When every edge costs at most C, the keys waiting in a Dijkstra queue all lie within
+ * [d, d + C], d being the last key popped. They are therefore kept in a ring of C + 1
+ * buckets indexed by key modulo C + 1: a push is an append and a pop scans forward to the
+ * next non-empty bucket, with no comparisons at all. Entries are not updated in place;
+ * the caller skips the stale ones it pops (lazy deletion).
+ *
+ * @tparam Value Type of the queued values (a state index, or a state packed with more data)
+ */
+template <typename Value = uint32_t>
+class BucketQueue
+{
+public:
+
+    /**
+     * @brief Empties the queue and sizes the ring for edge costs up to `maxCost`, keeping the buffers.
+     */
+    void Reset(uint32_t maxCost)
+    {
+        if (buckets.size() < std::size_t(maxCost) + 1)
+            buckets.resize(std::size_t(maxCost) + 1);
+        ring = std::size_t(maxCost) + 1;
+        for (std::size_t i = 0; i < ring; i++)
+            buckets[i].clear();
+        current = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Adds a value. `key` must lie within [last popped key, last popped key + maxCost].
+     */
+    void Push(uint64_t key, Value value)
+    {
+        buckets[key % ring].push_back(value);
+        count++;
+    }
+
+    /**
+     * @brief Removes a value with the smallest key. The queue must not be empty.
+     *
+     * @param key Receives the key of the value
+     */
+    Value Pop(uint64_t& key)
+    {
+        while (buckets[current % ring].empty())
+            current++;
+
+        std::vector<Value>& bucket = buckets[current % ring];
+        Value value = bucket.back();
+        bucket.pop_back();
+        count--;
+        key = current;
+        return value;
+    }
+
+    bool Empty() const { return count == 0; }   ///< True if no value is waiting
+
+    /**
+     * @brief Memory held by the buckets, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        std::size_t bytes = buckets.capacity() * sizeof(std::vector<Value>);
+        for (const auto& bucket : buckets)
+            bytes += bucket.capacity() * sizeof(Value);
+        return bytes;
+    }
+
+private:
+    std::vector<std::vector<Value>> buckets;    ///< Ring of buckets (only the first `ring` are used)
+    std::size_t ring = 1;                       ///< Number of buckets in use, maxCost + 1
+    uint64_t current = 0;                       ///< Key of the bucket the next scan starts from
+    std::size_t count = 0;                      ///< Number of values waiting
+};
+
+/**
+ * @brief Monotone priority queue for arbitrary edge costs (radix heap).
+ *
+ * Keys are grouped by the highest bit in which they differ from the last key popped, in 65
+ * buckets. A pop takes bucket 0 if it holds anything; otherwise it finds the first non-empty
+ * bucket, makes its smallest key the new reference and redistributes it into lower buckets.
+ * Each entry moves down at most 64 times, so an operation costs O(log C) amortized however
+ * large the costs are, where a bucket ring would need one bucket per possible cost.
+ */
+class RadixHeap
+{
+public:
+
+    /**
+     * @brief Empties the heap, keeping the buffers.
+     */
+    void Reset()
+    {
+        for (auto& bucket : buckets)
+            bucket.clear();
+        last = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Adds a value. `key` must not be smaller than the last key popped.
+     */
+    void Push(uint64_t key, uint32_t value)
+    {
+        buckets[BucketOf(key)].push_back({ key, value });
+        count++;
+    }
+
+    /**
+     * @brief Removes a value with the smallest key. The heap must not be empty.
+     *
+     * @param key Receives the key of the value
+     */
+    uint32_t Pop(uint64_t& key)
+    {
+        if (buckets[0].empty())
+        {
+            std::size_t i = 1;
+            while (buckets[i].empty())
+                i++;
+
+            // === The smallest key of bucket i becomes the reference; the rest moves down ===
+            last = std::min_element(buckets[i].begin(), buckets[i].end())->first;
+            for (const Entry& entry : buckets[i])
+                buckets[BucketOf(entry.first)].push_back(entry);
+            buckets[i].clear();
+        }
+
+        Entry entry = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        key = entry.first;
+        return entry.second;
+    }
+
+    bool Empty() const { return count == 0; }   ///< True if no value is waiting
+
+    /**
+     * @brief Memory held by the buckets, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        std::size_t bytes = 0;
+        for (const auto& bucket : buckets)
+            bytes += bucket.capacity() * sizeof(Entry);
+        return bytes;
+    }
+
+private:
+    using Entry = std::pair<uint64_t, uint32_t>;    ///< Key and value
+
+    std::vector<Entry> buckets[65];     ///< Bucket i holds keys whose highest bit differing from `last` is bit i - 1
+    uint64_t last = 0;                  ///< Last key popped (or the reference set by the last redistribution)
+    std::size_t count = 0;              ///< Number of values waiting
+
+    /**
+     * @brief Bucket of a key relative to `last`.
+     */
+    std::size_t BucketOf(uint64_t key) const
+    {
+        return key == last ? 0 : std::size_t(64 - std::countl_zero(key ^ last));
+    }
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include "Common.h"
+#include <numeric>
+
+/**
+ * @brief A query (L, S, W) divided by g = gcd(L, S), the form every engine and cache is given.
+ *
+ * Both jugs start empty and every operation moves a whole jugful or what is left of one, so
+ * every amount ever held is a multiple of g. Dividing the amounts by g therefore maps the
+ * states of (L, S) one to one onto those of (L / g, S / g), with every operation onto itself:
+ * (L, S, W) has exactly the shortest sequences of (L / g, S / g, W / g), in the same order,
+ * and none at all when g does not divide W.
+ *
+ * Reducing a query first rejects such targets in O(log L) without a search, gives the engines
+ * a state space g times smaller (they only index the 2 * (L + S) boundary states), and lets
+ * scaled copies of a jug pair share one solver, table or cache entry.
+ */
+struct CanonicalQuery
+{
+    uint64_t L;         ///< Capacity of the large jug, divided by g
+    uint64_t S;         ///< Capacity of the small jug, divided by g
+    uint64_t W;         ///< Target amount divided by g (0 if not solvable)
+    uint64_t scale;     ///< g = gcd(L, S)
+    bool solvable;      ///< false if g does not divide W, so that (W, 0) cannot be reached
+
+    /**
+     * @brief Reduces a query. Requires L > S.
+     */
+    static constexpr CanonicalQuery Reduce(uint64_t L, uint64_t S, uint64_t W)
+    {
+        uint64_t g = std::gcd(L, S);    // L > 0, so g > 0 (and g = L when S = 0)
+        if (W % g != 0)
+            return { L / g, S / g, 0, g, false };
+        return { L / g, S / g, W / g, g, true };
+    }
+};
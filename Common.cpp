@@ -1 +1 @@
-#include "Common.h"
+#include "Common.h"
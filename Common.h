@@ -1,25 +1,28 @@
-#pragma once
-
-// Standard I/O
-#include <iostream>
-#include <string>
-
-// Data structures
-#include <vector>
-#include <queue>
-#include <list>
-#include <set>
-#include <unordered_set>
-#include <unordered_map>
-#include <utility>
-
-// Algorithms and helpers
-#include <algorithm>
-#include <functional>
-#include <climits>      // For INT_MAX
-#include <chrono>       // For measuring execution time
-
-class Common
-{
-};
-
+#pragma once
+
+// Standard I/O
+#include <iostream>
+#include <string>
+
+// Data structures
+#include <vector>
+#include <queue>
+#include <list>
+#include <set>
+#include <unordered_set>
+#include <unordered_map>
+#include <utility>
+#include <span>
+
+// Algorithms and helpers
+#include <algorithm>
+#include <functional>
+#include <climits>      // For INT_MAX
+#include <cstdint>      // For fixed-width integer types
+#include <stdexcept>
+#include <chrono>       // For measuring execution time
+
+class Common
+{
+};
+
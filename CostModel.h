@@ -0,0 +1,39 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include <array>
+
+/**
+ * @brief Integer cost of each of the six operations, indexed by Move.
+ *
+ * The order is the one of Graph::generateAllEdges and Way2::CalculateAdjList. Costs may be
+ * zero; the unit model (every operation costs 1) makes the minimum cost equal to the minimum
+ * number of operations.
+ */
+struct CostModel
+{
+    std::array<uint32_t, MoveCount> costs = { 1, 1, 1, 1, 1, 1 };   ///< Cost of each operation
+
+    /**
+     * @brief Cost of one operation.
+     */
+    uint32_t operator[](Move move) const { return costs[std::size_t(move)]; }
+
+    /**
+     * @brief Largest cost of any operation.
+     */
+    uint32_t MaxCost() const { return *std::max_element(costs.begin(), costs.end()); }
+
+    /**
+     * @brief Smallest cost of any operation.
+     */
+    uint32_t MinCost() const { return *std::min_element(costs.begin(), costs.end()); }
+
+    /**
+     * @brief True if every cost is 0 or 1, so that a 0-1 BFS finds the minimum cost.
+     */
+    bool IsZeroOne() const
+    {
+        return std::all_of(costs.begin(), costs.end(), [](uint32_t c) { return c <= 1; });
+    }
+};
@@ -1,75 +1,908 @@
-#include "Way1.h"
-#include "Graph.h"
-#include "Way2.h"
-#include "Common.h"
-using namespace std;
-
-int main()
-{
-    int L, S, W, Way, Time;
-
-    cout << "Enter L (capacity of large jug): ";
-    cin >> L;
-
-    cout << "Enter S (capacity of small jug): ";
-    cin >> S;
-
-    cout << "Enter W (desired amount in large jug): ";
-    cin >> W;
-
-    // === Input validation ===
-    if (L <= S || W > L || L < 0 || S < 0 || W < 0) 
-    {
-        cerr << "Invalid input." << endl;
-        exit(1);
-    }
-
-    cout << "Enter Way (1 for full graph, 2 for on-the-fly): ";
-    cin >> Way;
-
-    // === Way validation ===
-    if (Way != 1 && Way != 2)
-    {
-        cerr << "Invalid way choice. Must be 1 or 2." << endl;
-        exit(1);
-    }
-
-    cout << "Do you want to measure time? (1 = yes, 0 = no): ";
-    cin >> Time;
-
-    // === Time validation ===
-    if (Time != 0 && Time != 1)
-    {
-        cerr << "Invalid way choice. Must be 0 or 1." << endl;
-        exit(1);
-    }
-
-    // === Output user selection ===
-    cout << "You selected: L = " << L << ", S = " << S << ", W = " << W
-        << ", Way = " << Way << ", Time = " << (Time ? "yes" : "no") << "\n";
-
-    // === Run selected implementation ===
-    std::cout << "\n\n";
-    if (Time == 1)
-    {
-        auto start = chrono::high_resolution_clock::now();
-
-        if (Way == 1)
-           Way1(L, S, W);
-        else
-           Way2(L, S, W);
-
-        auto end = chrono::high_resolution_clock::now();
-        auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
-        cout << "Function took " << duration.count() << " microseconds." << endl;
-    }
-    else 
-    {
-        if (Way == 1)
-            Way1(L, S, W);
-        else
-            Way2(L, S, W);
-    }
-
-    return 0;
-}
+#include "Way1.h"
+#include "Graph.h"
+#include "Way2.h"
+#include "Way3.h"
+#include "Way4.h"
+#include "Way5.h"
+#include "Batch.h"
+#include "Server.h"
+#include "Solver.h"
+#include "WeightedSolver.h"
+#include "AStarSolver.h"
+#include "JugSolver.h"
+#include "ExternalBfs.h"
+#include "FixedSolver.h"
+#include "PathWriter.h"
+#include "CanonicalQuery.h"
+#include "ShortestPaths.h"
+#include "Common.h"
+#include <charconv>
+using namespace std;
+
+/**
+ * @brief Parses a whole argument as an unsigned integer of at most `max`.
+ *
+ * Unlike stoul, a sign, trailing characters or a value above `max` is rejected instead of
+ * being wrapped or truncated.
+ *
+ * @throws std::invalid_argument if the argument is not a number, std::out_of_range if it exceeds `max`
+ */
+static uint64_t ParseUnsigned(const char* text, uint64_t max)
+{
+    const char* end = text + strlen(text);
+    uint64_t value;
+    auto [next, error] = from_chars(text, end, value);
+    if (error == errc::result_out_of_range || (error == errc() && next == end && value > max))
+        throw out_of_range(string("argument out of range: ") + text);
+    if (error != errc() || next != end)
+        throw invalid_argument(string("not a number: ") + text);
+    return value;
+}
+
+/**
+ * @brief Runs the non-interactive batch mode.
+ *
+ * Usage: Ex1 --batch [file] [--format text|csv|json] [--table] [--cache DIR]
+ * Reads queries from the file, or from standard input when no file is given.
+ * With --table, each (L, S) is solved once by a full BFS and all its W are looked up.
+ * With --cache, the same tables are kept as files in DIR and memory-mapped by later runs.
+ */
+static int RunBatch(int argc, char* argv[])
+{
+    const char* path = nullptr;
+    Batch::Format format = Batch::Format::Text;
+    bool useTables = false;
+    string cacheDirectory;
+    unsigned threads = 1;
+
+    // === Parse arguments ===
+    for (int i = 2; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc)
+        {
+            if (!Batch::ParseFormat(argv[++i], format))
+            {
+                cerr << "Invalid format. Must be text, csv or json." << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--table")
+            useTables = true;
+        else if (arg == "--cache" && i + 1 < argc)
+            cacheDirectory = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc)
+            threads = unsigned(atoi(argv[++i]));
+        else if (!path && arg.rfind("--", 0) != 0)
+            path = argv[i];
+        else
+        {
+            cerr << "Usage: " << argv[0] << " --batch [file] [--format text|csv|json] [--table] [--cache DIR] [--threads N]" << endl;
+            return 1;
+        }
+    }
+
+    FILE* in = stdin;
+    if (path && !(in = fopen(path, "rb")))
+    {
+        cerr << "Cannot open " << path << "." << endl;
+        return 1;
+    }
+
+    int status = 0;
+    try
+    {
+        Batch(in, stdout, format, useTables, cacheDirectory, threads).Run();
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << endl;
+        status = 1;
+    }
+
+    if (in != stdin)
+        fclose(in);
+    return status;
+}
+
+/**
+ * @brief Runs the long-running server mode.
+ *
+ * Usage: Ex1 --serve [--socket PATH] [--workers N] [--memory-mb N]
+ * Serves "L S W" requests on the Unix socket PATH, or on standard input and output when no
+ * socket is given. Solved tables are cached up to the memory budget (default 1024 MB).
+ */
+static int RunServer(int argc, char* argv[])
+{
+    string socketPath;
+    unsigned workers = 0;
+    unsigned long long memoryMb = 1024;
+
+    // === Parse arguments ===
+    for (int i = 2; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (arg == "--workers" && i + 1 < argc)
+            workers = unsigned(atoi(argv[++i]));
+        else if (arg == "--memory-mb" && i + 1 < argc)
+            memoryMb = strtoull(argv[++i], nullptr, 10);
+        else
+        {
+            cerr << "Usage: " << argv[0] << " --serve [--socket PATH] [--workers N] [--memory-mb N]" << endl;
+            return 1;
+        }
+    }
+
+    Server server(size_t(memoryMb) << 20, workers);
+    return socketPath.empty() ? server.RunStdio(stdin, stdout) : server.RunSocket(socketPath);
+}
+
+/**
+ * @brief Runs one way (its constructor prints the solution), then prints its stats if JUG_STATS is set.
+ */
+template <typename Engine, typename... Args>
+static void RunWay(Args... args)
+{
+    Engine engine(args...);
+    if constexpr (SearchStats::Enabled)
+        engine.Stats().Print(cout);
+}
+
+/**
+ * @brief Solves an N-jug instance with Solver<N> and prints the solution.
+ *
+ * With the Parallel strategy and `time`, the search is run again on one thread and with the
+ * serial PrebuiltGraph strategy (as in Way1), and the speedups are printed. The graph BFS is
+ * timed without building the graph, and skipped if the graph could need more than
+ * GraphCompareBytes.
+ */
+static constexpr uint64_t GraphCompareBytes = uint64_t(1) << 30;   ///< Largest graph built just for the comparison
+
+template <int N>
+static int SolveJugs(const vector<uint32_t>& capacities, int jug, uint32_t amount,
+    typename Solver<N>::Strategy strategy, unsigned threads, bool time)
+{
+    using Strategy = typename Solver<N>::Strategy;
+    std::array<uint32_t, N> capacity;
+    copy(capacities.begin(), capacities.end(), capacity.begin());
+    Solver<N> solver(capacity);
+    typename Solver<N>::JugHolds goal{ &solver, jug, amount };
+
+    std::optional<ParallelBfs> engine;
+    if (strategy == Strategy::Parallel)
+        engine.emplace(threads);   // workers are started before the clock
+
+    auto start = chrono::steady_clock::now();
+    auto moves = solver.Solve(goal, strategy, engine ? &*engine : nullptr);
+    auto end = chrono::steady_clock::now();
+
+    if (!moves)
+        cout << "No solution.\n";
+    else
+    {
+        cout << "Number of operations: " << moves->size() << "\n";
+        cout << "Operations:\n";
+        for (size_t i = 0; i < moves->size(); ++i)
+            cout << i + 1 << ". " << Solver<N>::MoveName((*moves)[i]) << "\n";
+    }
+
+    if (time)
+        cout << "Function took " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << " microseconds." << endl;
+
+    // === Speedup of the parallel search over one thread and over the serial graph BFS ===
+    if (time && engine)
+    {
+        auto elapsed = [&](auto&& run)
+        {
+            auto begin = chrono::steady_clock::now();
+            run();
+            return max(1LL, (long long)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - begin).count());
+        };
+        long long parallel = max(1LL, (long long)chrono::duration_cast<chrono::microseconds>(end - start).count());
+        ParallelBfs single(1);
+        long long oneThread = elapsed([&] { solver.Solve(goal, Strategy::Parallel, &single); });
+
+        cout << "Parallel BFS (" << engine->Threads() << " threads, " << engine->ParallelLevels() << " levels in parallel, "
+            << engine->BottomUpLevels() << " bottom-up): " << parallel << " microseconds; 1 thread: " << oneThread
+            << " microseconds (speedup " << double(oneThread) / double(parallel) << "x); ";
+
+        if (!solver.GraphFits() || solver.GraphBytes() > GraphCompareBytes)
+            cout << "serial graph BFS: skipped (the graph could need " << (solver.GraphBytes() >> 20) << " MB)" << endl;
+        else
+        {
+            long long searchNs = 0;
+            solver.Solve(goal, Strategy::PrebuiltGraph, nullptr, &searchNs);
+            long long graph = max(1LL, searchNs / 1000);
+            cout << "serial graph BFS, search only: " << graph << " microseconds (speedup "
+                << double(graph) / double(parallel) << "x)" << endl;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs the N-jug mode.
+ *
+ * Usage: Ex1 --jugs C1 C2 ... Cn --target JUG AMOUNT [--strategy graph|fly|parallel] [--threads N] [--time]
+ * Finds the shortest way to get AMOUNT into jug number JUG (1-based), for 2 to 6 jugs. The
+ * parallel strategy uses N threads (default: one per hardware thread).
+ */
+static int RunJugs(int argc, char* argv[])
+{
+    vector<uint32_t> capacities;
+    int jug = 0;
+    long long amount = -1;
+    string strategy = "graph";
+    unsigned threads = 0;
+    bool time = false;
+
+    // === Parse arguments ===
+    try
+    {
+        int i = 2;
+        for (; i < argc && string(argv[i]).rfind("--", 0) != 0; i++)
+            capacities.push_back(uint32_t(ParseUnsigned(argv[i], UINT32_MAX)));
+
+        for (; i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--target" && i + 2 < argc)
+            {
+                jug = stoi(argv[++i]);
+                amount = stoll(argv[++i]);
+            }
+            else if (arg == "--strategy" && i + 1 < argc)
+                strategy = argv[++i];
+            else if (arg == "--threads" && i + 1 < argc)
+                threads = unsigned(ParseUnsigned(argv[++i], UINT_MAX));
+            else if (arg == "--time")
+                time = true;
+            else
+                amount = -1;
+        }
+    }
+    catch (const exception&)
+    {
+        amount = -1; // not a number
+    }
+
+    // === Input validation ===
+    int n = int(capacities.size());
+    bool knownStrategy = strategy == "graph" || strategy == "fly" || strategy == "parallel";
+    if (n < 2 || n > 6 || jug < 1 || jug > n || amount < 0 || amount > capacities[jug - 1] || !knownStrategy)
+    {
+        cerr << "Usage: " << argv[0] << " --jugs C1 C2 ... Cn --target JUG AMOUNT [--strategy graph|fly|parallel] [--threads N] [--time]"
+            << " (2 to 6 jugs)" << endl;
+        return 1;
+    }
+
+    // The strategies have the same order in every Solver<N>
+    auto pick = [&]<int N>() -> typename Solver<N>::Strategy
+    {
+        using Strategy = typename Solver<N>::Strategy;
+        return strategy == "fly" ? Strategy::OnTheFly : strategy == "parallel" ? Strategy::Parallel : Strategy::PrebuiltGraph;
+    };
+
+    try
+    {
+        switch (n)
+        {
+        case 2: return SolveJugs<2>(capacities, jug - 1, uint32_t(amount), pick.operator()<2>(), threads, time);
+        case 3: return SolveJugs<3>(capacities, jug - 1, uint32_t(amount), pick.operator()<3>(), threads, time);
+        case 4: return SolveJugs<4>(capacities, jug - 1, uint32_t(amount), pick.operator()<4>(), threads, time);
+        case 5: return SolveJugs<5>(capacities, jug - 1, uint32_t(amount), pick.operator()<5>(), threads, time);
+        default: return SolveJugs<6>(capacities, jug - 1, uint32_t(amount), pick.operator()<6>(), threads, time);
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << endl;
+        return 1;
+    }
+}
+
+/**
+ * @brief Runs the weighted mode.
+ *
+ * Usage: Ex1 --weighted L S W [--costs FL FS EL ES PLS PSL] [--path full|compact|count] [--time]
+ * Reduces the query by gcd(L, S), then finds a sequence of operations of minimum total cost, each
+ * operation costing the given integer.
+ */
+static int RunWeighted(int argc, char* argv[])
+{
+    long long L = -1, S = -1, W = -1;
+    CostModel costs;
+    PathFormat pathFormat = PathFormat::Full;
+    bool time = false, valid = argc >= 5;
+
+    // === Parse arguments ===
+    try
+    {
+        if (valid)
+        {
+            L = stoll(argv[2]);
+            S = stoll(argv[3]);
+            W = stoll(argv[4]);
+        }
+
+        for (int i = 5; valid && i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--costs" && i + MoveCount < argc)
+            {
+                for (int m = 0; m < MoveCount; m++)
+                    costs.costs[m] = uint32_t(ParseUnsigned(argv[++i], UINT32_MAX));
+            }
+            else if (arg == "--path" && i + 1 < argc)
+                valid = PathWriter::ParseFormat(argv[++i], pathFormat);
+            else if (arg == "--time")
+                time = true;
+            else
+                valid = false;
+        }
+    }
+    catch (const exception&)
+    {
+        valid = false; // not a number
+    }
+
+    // === Input validation ===
+    if (!valid || S < 0 || L <= S || W < 0 || W > L || L > INT_MAX)
+    {
+        cerr << "Usage: " << argv[0] << " --weighted L S W [--costs FL FS EL ES PLS PSL]"
+            << " [--path full|compact|count] [--time]" << endl;
+        return 1;
+    }
+
+    // === Reduce by gcd(L, S): scaling keeps every operation and its cost, and no search runs for an unreachable W ===
+    WeightedSolver solver(costs);
+    WeightedSolver::Result result;
+    auto start = chrono::steady_clock::now();
+    CanonicalQuery query = CanonicalQuery::Reduce(uint64_t(L), uint64_t(S), uint64_t(W));
+    if (query.solvable)
+        result = solver.Solve(int(query.L), int(query.S), int(query.W));
+    auto end = chrono::steady_clock::now();
+
+    PathWriter writer(cout, pathFormat);
+    if (!result.solved)
+        writer.WriteNoSolution();
+    else
+    {
+        cout << "Minimum cost: " << result.cost << "\n";
+        writer.Write(result.moves, result.operations);
+    }
+
+    if (time)
+        cout << "Function took " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << " microseconds." << endl;
+    if constexpr (SearchStats::Enabled)
+        result.stats.Print(cout);
+    return 0;
+}
+
+/**
+ * @brief Runs the A* mode.
+ *
+ * Usage: Ex1 --astar L S W [--path full|compact|count] [--time] [--compare]
+ * Reduces the query by gcd(L, S) and finds a shortest sequence of operations with AStarSolver.
+ * With --compare, it then runs Way2's BFS on the same reduced query (without printing) and reports
+ * how many fewer states A* expanded; that BFS takes far longer than A* on large jugs.
+ */
+static int RunAStar(int argc, char* argv[])
+{
+    long long L = -1, S = -1, W = -1;
+    PathFormat pathFormat = PathFormat::Full;
+    bool time = false, compare = false, valid = argc >= 5;
+
+    // === Parse arguments ===
+    try
+    {
+        if (valid)
+        {
+            L = stoll(argv[2]);
+            S = stoll(argv[3]);
+            W = stoll(argv[4]);
+        }
+
+        for (int i = 5; valid && i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--path" && i + 1 < argc)
+                valid = PathWriter::ParseFormat(argv[++i], pathFormat);
+            else if (arg == "--time")
+                time = true;
+            else if (arg == "--compare")
+                compare = true;
+            else
+                valid = false;
+        }
+    }
+    catch (const exception&)
+    {
+        valid = false; // not a number
+    }
+
+    // === Input validation ===
+    if (!valid || S < 0 || L <= S || W < 0 || W > L || L > INT_MAX)
+    {
+        cerr << "Usage: " << argv[0] << " --astar L S W [--path full|compact|count] [--time] [--compare]" << endl;
+        return 1;
+    }
+
+    // === Reduce by gcd(L, S): the solver gets the canonical query, and no search runs for an unreachable W ===
+    AStarSolver solver;
+    AStarSolver::Result result;
+    auto start = chrono::steady_clock::now();
+    CanonicalQuery query = CanonicalQuery::Reduce(uint64_t(L), uint64_t(S), uint64_t(W));
+    if (query.solvable)
+        result = solver.Solve(int(query.L), int(query.S), int(query.W));
+    auto end = chrono::steady_clock::now();
+
+    PathWriter writer(cout, pathFormat);
+    if (!result.solved)
+        writer.WriteNoSolution();
+    else
+        writer.Write(result.moves, result.operations);
+
+    if (time)
+        cout << "Function took " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << " microseconds." << endl;
+
+    // === Compare with the BFS of Way2 on the same query (which also counts the goal it takes off the queue) ===
+    if (compare && query.solvable)
+    {
+        Way2 bfs(int(query.L), int(query.S), int(query.W), false);
+        uint64_t astarExpanded = result.expanded + (result.solved ? 1 : 0);
+        uint64_t bfsExpanded = bfs.StatesExpanded();
+        cout << "Expanded states: " << astarExpanded << " (Way2 BFS: " << bfsExpanded << ", "
+            << (bfsExpanded >= astarExpanded ? bfsExpanded - astarExpanded : 0) << " fewer"
+            << (result.informed ? "" : ", no heuristic: searched in BFS order") << ")" << endl;
+    }
+    else if (compare)
+        cout << "Expanded states: 0 (W is not a multiple of gcd(L, S))" << endl;
+
+    if constexpr (SearchStats::Enabled)
+        result.stats.Print(cout);
+    return 0;
+}
+
+/**
+ * @brief Runs the external-memory BFS mode.
+ *
+ * Usage: Ex1 --external L S W [--memory-mb N | --memory-bytes N] [--temp DIR] [--path full|compact|count] [--time] [--check]
+ * Reduces the query by gcd(L, S) and finds a shortest sequence of operations with ExternalBfs,
+ * which keeps the levels of the search in files under DIR (the system's temporary directory by
+ * default) and holds at most N MB (default 256) of them in memory, then reports the file traffic.
+ * --memory-bytes sets the budget in bytes instead, down to ExternalBfs::MinMemoryBytes, which is
+ * small enough to make the search spill runs and stream its levels. --check also solves the query
+ * with JugSolver and fails unless both find the same number of operations and the moves lead to
+ * (W, 0) with the original jugs.
+ */
+static int RunExternal(int argc, char* argv[])
+{
+    long long L = -1, S = -1, W = -1;
+    unsigned long long memoryMb = ExternalBfs::DefaultMemoryBytes >> 20, memoryBytes = 0;
+    string directory;
+    PathFormat pathFormat = PathFormat::Full;
+    bool time = false, check = false, valid = argc >= 5;
+
+    // === Parse arguments ===
+    try
+    {
+        if (valid)
+        {
+            L = stoll(argv[2]);
+            S = stoll(argv[3]);
+            W = stoll(argv[4]);
+        }
+
+        for (int i = 5; valid && i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--memory-mb" && i + 1 < argc)
+                memoryMb = stoull(argv[++i]);
+            else if (arg == "--memory-bytes" && i + 1 < argc)
+                memoryBytes = stoull(argv[++i]);
+            else if (arg == "--temp" && i + 1 < argc)
+                directory = argv[++i];
+            else if (arg == "--path" && i + 1 < argc)
+                valid = PathWriter::ParseFormat(argv[++i], pathFormat);
+            else if (arg == "--time")
+                time = true;
+            else if (arg == "--check")
+                check = true;
+            else
+                valid = false;
+        }
+    }
+    catch (const exception&)
+    {
+        valid = false; // not a number
+    }
+
+    // === Input validation ===
+    if (!valid || S < 0 || L <= S || W < 0 || W > L || L > INT_MAX || memoryMb == 0 || memoryMb > (SIZE_MAX >> 20)
+        || memoryBytes > SIZE_MAX)
+    {
+        cerr << "Usage: " << argv[0] << " --external L S W [--memory-mb N | --memory-bytes N] [--temp DIR] [--path full|compact|count] [--time] [--check]" << endl;
+        return 1;
+    }
+
+    // === Reduce by gcd(L, S): the solver gets the canonical query, and no search runs for an unreachable W ===
+    ExternalBfs::Result result;
+    CanonicalQuery query = CanonicalQuery::Reduce(uint64_t(L), uint64_t(S), uint64_t(W));
+    auto start = chrono::steady_clock::now();
+    try
+    {
+        ExternalBfs solver(memoryBytes != 0 ? size_t(memoryBytes) : size_t(memoryMb) << 20, directory);
+        if (query.solvable)
+            result = solver.Solve(int(query.L), int(query.S), int(query.W));
+
+        auto end = chrono::steady_clock::now();
+        PathWriter writer(cout, pathFormat);
+        if (!result.solved)
+            writer.WriteNoSolution();
+        else
+            writer.Write(result.moves, result.operations);
+
+        if (time)
+            cout << "Function took " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+                << " microseconds." << endl;
+
+        if (check && query.solvable)
+        {
+            // === Compare with the in-memory BFS and replay the moves on the original jugs (valid until the solver goes) ===
+            JugSolver::Result expected = JugSolver().Solve(int(query.L), int(query.S), int(query.W));
+            int big = 0, small = 0, toBig, toSmall;
+            bool legal = true;
+            for (Move move : result.moves)
+            {
+                legal = legal && ApplyMove(move, int(L), int(S), big, small, toBig, toSmall);
+                big = toBig;
+                small = toSmall;
+            }
+            if (result.solved != expected.solved || result.operations != expected.operations
+                || !legal || (result.solved && (big != W || small != 0)))
+            {
+                cerr << "Check failed: JugSolver finds " << (expected.solved ? to_string(expected.operations) : "no")
+                    << " operations" << (legal ? "" : ", and the moves are not legal") << endl;
+                return 1;
+            }
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    cout << "Levels: " << result.levels << ", runs spilled: " << result.runs << ", bytes written: "
+        << result.bytesWritten << ", bytes read: " << result.bytesRead << endl;
+    if constexpr (SearchStats::Enabled)
+        result.stats.Print(cout);
+    return 0;
+}
+
+/**
+ * @brief Answers from the FixedSolver tables of (FixedL, FixedS) if the query is for that pair.
+ *
+ * @return false if the query is for another pair
+ */
+template <int FixedL, int FixedS>
+static bool AnswerFixed(uint64_t L, uint64_t S, uint64_t W, PathFormat pathFormat)
+{
+    if (L != uint64_t(FixedL) || S != uint64_t(FixedS))
+        return false;
+
+    auto result = FixedSolver<FixedL, FixedS>::Solve(int(W));
+    PathWriter writer(cout, pathFormat);
+    if (!result.solved)
+        writer.WriteNoSolution();
+    else
+        writer.Write(result.moves, result.operations);
+    return true;
+}
+
+/**
+ * @brief Runs the compile-time table mode.
+ *
+ * Usage: Ex1 --fixed L S W [--path full|compact|count] [--time]
+ * Reduces the query by gcd(L, S) and answers it from the FixedSolver tables compiled in for
+ * the reduced pair, without any search; only the pairs listed below are available.
+ */
+static int RunFixed(int argc, char* argv[])
+{
+    long long L = -1, S = -1, W = -1;
+    PathFormat pathFormat = PathFormat::Full;
+    bool time = false, valid = argc >= 5;
+
+    // === Parse arguments ===
+    try
+    {
+        if (valid)
+        {
+            L = stoll(argv[2]);
+            S = stoll(argv[3]);
+            W = stoll(argv[4]);
+        }
+
+        for (int i = 5; valid && i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--path" && i + 1 < argc)
+                valid = PathWriter::ParseFormat(argv[++i], pathFormat);
+            else if (arg == "--time")
+                time = true;
+            else
+                valid = false;
+        }
+    }
+    catch (const exception&)
+    {
+        valid = false; // not a number
+    }
+
+    // === Input validation ===
+    if (!valid || S < 0 || L <= S || W < 0 || W > L)
+    {
+        cerr << "Usage: " << argv[0] << " --fixed L S W [--path full|compact|count] [--time]" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    CanonicalQuery query = CanonicalQuery::Reduce(uint64_t(L), uint64_t(S), uint64_t(W));
+    bool answered = true;
+    if (!query.solvable)
+        PathWriter(cout, pathFormat).WriteNoSolution();
+    else
+        answered = AnswerFixed<4, 3>(query.L, query.S, query.W, pathFormat)
+            || AnswerFixed<5, 3>(query.L, query.S, query.W, pathFormat)
+            || AnswerFixed<7, 5>(query.L, query.S, query.W, pathFormat)
+            || AnswerFixed<9, 4>(query.L, query.S, query.W, pathFormat)
+            || AnswerFixed<10, 3>(query.L, query.S, query.W, pathFormat)
+            || AnswerFixed<13, 5>(query.L, query.S, query.W, pathFormat);
+    auto end = chrono::steady_clock::now();
+
+    if (!answered)
+    {
+        cerr << "No table compiled in for (" << query.L << ", " << query.S << "), the query reduced by gcd(L, S)."
+            << " Available: (4, 3), (5, 3), (7, 5), (9, 4), (10, 3), (13, 5) and their multiples." << endl;
+        return 1;
+    }
+
+    if (time)
+        cout << "Function took " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << " microseconds." << endl;
+    return 0;
+}
+
+/**
+ * @brief Runs the all-shortest-solutions mode.
+ *
+ * Usage: Ex1 --all L S W [--limit K] [--time]
+ * Reduces the query by gcd(L, S), counts its distinct shortest sequences with ShortestPaths and
+ * prints the first K of them (default 10) in lexicographic order, one per line in compact form.
+ */
+static int RunAll(int argc, char* argv[])
+{
+    long long L = -1, S = -1, W = -1;
+    unsigned long long limit = 10;
+    bool time = false, valid = argc >= 5;
+
+    // === Parse arguments ===
+    try
+    {
+        if (valid)
+        {
+            L = stoll(argv[2]);
+            S = stoll(argv[3]);
+            W = stoll(argv[4]);
+        }
+
+        for (int i = 5; valid && i < argc; i++)
+        {
+            string arg = argv[i];
+            if (arg == "--limit" && i + 1 < argc)
+                limit = stoull(argv[++i]);
+            else if (arg == "--time")
+                time = true;
+            else
+                valid = false;
+        }
+    }
+    catch (const exception&)
+    {
+        valid = false; // not a number
+    }
+
+    // === Input validation ===
+    if (!valid || S < 0 || L <= S || W < 0 || W > L || L > INT_MAX)
+    {
+        cerr << "Usage: " << argv[0] << " --all L S W [--limit K] [--time]" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    CanonicalQuery query = CanonicalQuery::Reduce(uint64_t(L), uint64_t(S), uint64_t(W));
+    if (!query.solvable)
+    {
+        PathWriter(cout, PathFormat::Full).WriteNoSolution();
+        return 0;
+    }
+
+    ShortestPaths solver;
+    ShortestPaths::Result result = solver.Solve(int(query.L), int(query.S), int(query.W));
+    if (!result.solved)
+    {
+        PathWriter(cout, PathFormat::Full).WriteNoSolution();
+        return 0;
+    }
+
+    cout << "Number of operations: " << result.operations << endl;
+    cout << "Shortest solutions: " << result.count << " (DAG of " << result.dagStates << " states, "
+        << result.dagEdges << " operations)" << endl;
+
+    // === The first `limit` sequences, generated one at a time ===
+    ShortestPaths::Enumerator sequences = solver.Enumerate();
+    string line;
+    for (unsigned long long i = 1; i <= limit && sequences.Next(); i++)
+    {
+        line = to_string(i) + ".";
+        for (Move move : sequences.Moves())
+        {
+            line += line.back() == '.' ? " " : ",";
+            line += MoveCode(move);
+        }
+        cout << line << '\n';
+    }
+    auto end = chrono::steady_clock::now();
+
+    if (time)
+        cout << "Function took " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << " microseconds." << endl;
+    if constexpr (SearchStats::Enabled)
+        result.stats.Print(cout);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    PathFormat pathFormat = PathFormat::Full;
+    if (argc == 3 && string(argv[1]) == "--path")
+    {
+        if (!PathWriter::ParseFormat(argv[2], pathFormat))
+        {
+            cerr << "Invalid path format. Must be full, compact or count." << endl;
+            return 1;
+        }
+    }
+    else if (argc > 1)
+    {
+        if (string(argv[1]) == "--batch")
+            return RunBatch(argc, argv);
+        if (string(argv[1]) == "--jugs")
+            return RunJugs(argc, argv);
+        if (string(argv[1]) == "--serve")
+            return RunServer(argc, argv);
+        if (string(argv[1]) == "--weighted")
+            return RunWeighted(argc, argv);
+        if (string(argv[1]) == "--astar")
+            return RunAStar(argc, argv);
+        if (string(argv[1]) == "--external")
+            return RunExternal(argc, argv);
+        if (string(argv[1]) == "--fixed")
+            return RunFixed(argc, argv);
+        if (string(argv[1]) == "--all")
+            return RunAll(argc, argv);
+
+        cerr << "Usage: " << argv[0] << " [--batch [file] [--format text|csv|json] [--table] [--cache DIR] [--threads N]]" << endl;
+        cerr << "       " << argv[0] << " [--jugs C1 C2 ... Cn --target JUG AMOUNT [--strategy graph|fly|parallel] [--threads N] [--time]]" << endl;
+        cerr << "       " << argv[0] << " [--serve [--socket PATH] [--workers N] [--memory-mb N]]" << endl;
+        cerr << "       " << argv[0] << " [--weighted L S W [--costs FL FS EL ES PLS PSL] [--path full|compact|count] [--time]]" << endl;
+        cerr << "       " << argv[0] << " [--astar L S W [--path full|compact|count] [--time] [--compare]]" << endl;
+        cerr << "       " << argv[0] << " [--external L S W [--memory-mb N | --memory-bytes N] [--temp DIR] [--path full|compact|count] [--time] [--check]]" << endl;
+        cerr << "       " << argv[0] << " [--fixed L S W [--path full|compact|count] [--time]]" << endl;
+        cerr << "       " << argv[0] << " [--all L S W [--limit K] [--time]]" << endl;
+        cerr << "       " << argv[0] << " [--path full|compact|count]" << endl;
+        return 1;
+    }
+
+    long long L, S, W;
+    int Way, Time;
+
+    cout << "Enter L (capacity of large jug): ";
+    cin >> L;
+
+    cout << "Enter S (capacity of small jug): ";
+    cin >> S;
+
+    cout << "Enter W (desired amount in large jug): ";
+    cin >> W;
+
+    // === Input validation ===
+    if (L <= S || W > L || L < 0 || S < 0 || W < 0) 
+    {
+        cerr << "Invalid input." << endl;
+        exit(1);
+    }
+
+    cout << "Enter Way (1 for full graph, 2 for on-the-fly, 3 for closed form, 4 for parallel BFS, 5 for bidirectional BFS): ";
+    cin >> Way;
+
+    // === Way validation ===
+    if (Way < 1 || Way > 5)
+    {
+        cerr << "Invalid way choice. Must be between 1 and 5." << endl;
+        exit(1);
+    }
+
+    // === Capacity validation (Way 1 and Way 2 index states with int) ===
+    if ((Way == 3 && (unsigned long long)L > Way3::MaxCapacity) || (Way != 3 && L > INT_MAX))
+    {
+        cerr << "Capacity too large for the selected way." << endl;
+        exit(1);
+    }
+
+    cout << "Do you want to measure time? (1 = yes, 0 = no): ";
+    cin >> Time;
+
+    // === Time validation ===
+    if (Time != 0 && Time != 1)
+    {
+        cerr << "Invalid way choice. Must be 0 or 1." << endl;
+        exit(1);
+    }
+
+    // === Output user selection ===
+    cout << "You selected: L = " << L << ", S = " << S << ", W = " << W
+        << ", Way = " << Way << ", Time = " << (Time ? "yes" : "no") << "\n";
+
+    // === Reduce by gcd(L, S): the engine gets the canonical query, and no search runs for an unreachable W ===
+    CanonicalQuery query = CanonicalQuery::Reduce(uint64_t(L), uint64_t(S), uint64_t(W));
+    L = (long long)query.L;
+    S = (long long)query.S;
+    W = (long long)query.W;
+
+    auto solve = [&]
+    {
+        if (!query.solvable)
+            PathWriter(cout, pathFormat).WriteNoSolution();
+        else if (Way == 1)
+            RunWay<Way1>(int(L), int(S), int(W), true, pathFormat);
+        else if (Way == 2)
+            RunWay<Way2>(int(L), int(S), int(W), true, pathFormat);
+        else if (Way == 3)
+            RunWay<Way3>(L, S, W, pathFormat);
+        else if (Way == 4)
+            RunWay<Way4>(int(L), int(S), int(W), true, pathFormat);
+        else
+            RunWay<Way5>(int(L), int(S), int(W), true, pathFormat);
+    };
+
+    // === Run selected implementation ===
+    std::cout << "\n\n";
+    if (Time == 1)
+    {
+        auto start = chrono::high_resolution_clock::now();
+        solve();
+        auto end = chrono::high_resolution_clock::now();
+        auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
+        cout << "Function took " << duration.count() << " microseconds." << endl;
+
+        if (Way == 4 && query.solvable)
+            Way4::ReportSpeedup(int(L), int(S), int(W));
+
+        if (Way == 5 && query.solvable)
+        {
+            Way5 search(int(L), int(S), int(W), false);
+            cout << "States visited: " << search.StatesVisited() << " of " << search.StateCount() << endl;
+        }
+    }
+    else
+        solve();
+
+    return 0;
+}
@@ -0,0 +1,636 @@
+#include "ExternalBfs.h"
+#include "Common.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Closes a FILE* owned by a std::unique_ptr.
+     */
+    struct FileCloser
+    {
+        void operator()(FILE* file) const { fclose(file); }
+    };
+
+    using FilePtr = std::unique_ptr<FILE, FileCloser>;
+
+    /**
+     * @brief Opens a file with a stdio buffer of `blockBytes`, or unbuffered if 0 (the caller reads whole blocks).
+     */
+    FilePtr Open(const std::string& path, const char* mode, std::size_t blockBytes)
+    {
+        FilePtr file(fopen(path.c_str(), mode));
+        if (!file)
+            throw std::runtime_error("ExternalBfs: cannot open " + path);
+        setvbuf(file.get(), nullptr, blockBytes ? _IOFBF : _IONBF, blockBytes);
+        return file;
+    }
+
+    /**
+     * @brief Moves to a byte offset, which may be past 2 GB.
+     */
+    void Seek(FILE* file, uint64_t offset, const std::string& path)
+    {
+#ifdef _WIN32
+        bool ok = _fseeki64(file, int64_t(offset), SEEK_SET) == 0;
+#else
+        bool ok = fseeko(file, off_t(offset), SEEK_SET) == 0;
+#endif
+        if (!ok)
+            throw std::runtime_error("ExternalBfs: cannot seek in " + path);
+    }
+
+    /**
+     * @brief Sorted values read in order, either from memory or from a range of a file through a buffer.
+     */
+    template <typename T>
+    class Stream
+    {
+    public:
+
+        /**
+         * @brief Reads the values of `values`.
+         */
+        explicit Stream(std::span<const T> values) : data(values.data()), size(values.size()) {}
+
+        /**
+         * @brief Reads `count` values starting at byte `offset` of `path`, `buffer.size()` values at a time.
+         */
+        Stream(const std::string& _path, uint64_t offset, uint64_t count, std::span<T> _buffer, uint64_t& _bytesRead)
+            : path(_path), file(Open(_path, "rb", 0)), remaining(count), buffer(_buffer), bytesRead(&_bytesRead)
+        {
+            Seek(file.get(), offset, path);
+            Refill();
+        }
+
+        bool Empty() const { return position == size; }     ///< true once every value was popped
+        T Front() const { return data[position]; }          ///< The smallest value not popped yet
+
+        /**
+         * @brief Drops the front value.
+         */
+        void Pop()
+        {
+            if (++position == size && remaining > 0)
+                Refill();
+        }
+
+        /**
+         * @brief Drops the values below `value` and tells whether `value` comes next.
+         */
+        bool Contains(T value)
+        {
+            while (!Empty() && Front() < value)
+                Pop();
+            return !Empty() && Front() == value;
+        }
+
+    private:
+        const T* data = nullptr;        ///< Values being read
+        std::size_t position = 0;       ///< Index of the front value in `data`
+        std::size_t size = 0;           ///< Number of values in `data`
+
+        std::string path;
+        FilePtr file;                   ///< Null when reading from memory
+        uint64_t remaining = 0;         ///< Values of the range not read from the file yet
+        std::span<T> buffer;
+        uint64_t* bytesRead = nullptr;
+
+        void Refill()
+        {
+            std::size_t count = std::size_t(std::min<uint64_t>(remaining, buffer.size()));
+            if (fread(buffer.data(), sizeof(T), count, file.get()) != count)
+                throw std::runtime_error("ExternalBfs: cannot read " + path);
+            *bytesRead += count * sizeof(T);
+            remaining -= count;
+            data = buffer.data();
+            position = 0;
+            size = count;
+        }
+    };
+
+    /**
+     * @brief Reads the states of a level, from memory if it is cached, else from the index file through its `ids` buffer.
+     */
+    template <typename Files, typename Level>
+    Stream<uint32_t> OpenLevel(Files& files, Level& level, std::size_t capacity)
+    {
+        if (level.cached)
+            return Stream<uint32_t>(std::span<const uint32_t>(level.ids));
+        level.ids.resize(capacity);
+        return Stream<uint32_t>(files.ids->path, level.offset, level.count, std::span<uint32_t>(level.ids), files.read);
+    }
+
+    /**
+     * @brief Random reads from a file through one cached block, for walking the levels backwards.
+     */
+    class BlockReader
+    {
+    public:
+        BlockReader(const std::string& _path, uint64_t _fileBytes, std::size_t blockBytes, uint64_t& _bytesRead)
+            : path(_path), file(Open(_path, "rb", 0)), fileBytes(_fileBytes), block(blockBytes), bytesRead(&_bytesRead)
+        {
+        }
+
+        /**
+         * @brief Copies `bytes` bytes at byte `offset` to `out`, loading the blocks they lie in.
+         */
+        void Read(uint64_t offset, void* out, std::size_t bytes)
+        {
+            auto* to = static_cast<char*>(out);
+            while (bytes > 0)
+            {
+                uint64_t start = offset / block.size() * block.size();
+                if (start != first)
+                {
+                    std::size_t count = std::size_t(std::min<uint64_t>(block.size(), fileBytes - start));
+                    Seek(file.get(), start, path);
+                    if (fread(block.data(), 1, count, file.get()) != count)
+                        throw std::runtime_error("ExternalBfs: cannot read " + path);
+                    *bytesRead += count;
+                    first = start;
+                }
+
+                std::size_t count = std::min<std::size_t>(bytes, std::size_t(start + block.size() - offset));
+                std::copy_n(block.data() + (offset - start), count, to);
+                to += count;
+                offset += count;
+                bytes -= count;
+            }
+        }
+
+    private:
+        std::string path;
+        FilePtr file;
+        uint64_t fileBytes;             ///< Size of the file
+        std::vector<char> block;
+        uint64_t first = UINT64_MAX;    ///< Offset of the block held in `block`
+        uint64_t* bytesRead;
+    };
+
+    /**
+     * @brief A file written from the start through a buffer of one block, so that every write is a whole block.
+     */
+    class Appender
+    {
+    public:
+        std::string path;
+        uint64_t size = 0;              ///< Bytes appended, including those still in the buffer
+
+        Appender(const std::string& _path, std::size_t blockBytes, uint64_t& _bytesWritten)
+            : path(_path), file(Open(_path, "wb", 0)), buffer(blockBytes), bytesWritten(&_bytesWritten)
+        {
+        }
+
+        /**
+         * @brief Appends `bytes` bytes.
+         */
+        void Write(const void* data, std::size_t bytes)
+        {
+            if (used + bytes > buffer.size())
+                Flush();
+            if (bytes > buffer.size())
+                Put(data, bytes);
+            else
+            {
+                std::memcpy(buffer.data() + used, data, bytes);
+                used += bytes;
+            }
+            size += bytes;
+        }
+
+        /**
+         * @brief Writes out the buffer, making everything appended visible to readers of the file.
+         */
+        void Flush()
+        {
+            Put(buffer.data(), used);
+            used = 0;
+        }
+
+        /**
+         * @brief Starts writing the file from the start again.
+         */
+        void Rewind()
+        {
+            used = 0;
+            size = 0;
+            Seek(file.get(), 0, path);
+        }
+
+    private:
+        FilePtr file;
+        std::vector<char> buffer;
+        std::size_t used = 0;           ///< Bytes in the buffer
+        uint64_t* bytesWritten;
+
+        void Put(const void* data, std::size_t bytes)
+        {
+            if (bytes > 0 && fwrite(data, 1, bytes, file.get()) != bytes)
+                throw std::runtime_error("ExternalBfs: cannot write " + path);
+            *bytesWritten += bytes;
+        }
+    };
+}
+
+/**
+ * @brief The temporary directory of one query and its three files, removed when the query ends.
+ */
+struct ExternalBfs::Files
+{
+    std::filesystem::path root;         ///< The temporary directory
+    uint64_t written = 0, read = 0;     ///< Bytes moved in total
+    std::optional<Appender> ids;        ///< The levels: sorted states, then the size
+    std::optional<Appender> moves;      ///< The operation that reached each state of `ids`
+    std::optional<Appender> runs;       ///< The runs of the current level
+
+    Files(const std::string& parent, std::size_t blockBytes)
+    {
+        static std::atomic<uint64_t> sequence{ 0 };    // tells apart the queries of one process
+#ifdef _WIN32
+        int process = _getpid();
+#else
+        int process = getpid();
+#endif
+        std::error_code error;
+        std::filesystem::path base = parent.empty() ? std::filesystem::temp_directory_path(error) : std::filesystem::path(parent);
+        root = base / ("jug-bfs-" + std::to_string(process) + "-" + std::to_string(sequence++));
+        if (error || !std::filesystem::create_directory(root, error))
+            throw std::runtime_error("ExternalBfs: cannot create " + root.string());
+
+        try
+        {
+            ids.emplace((root / "levels.bin").string(), blockBytes, written);
+            moves.emplace((root / "moves.bin").string(), blockBytes, written);
+            runs.emplace((root / "runs.bin").string(), blockBytes, written);
+        }
+        catch (...)
+        {
+            Remove();
+            throw;
+        }
+    }
+
+    Files(const Files&) = delete;
+    Files& operator=(const Files&) = delete;
+
+    ~Files()
+    {
+        Remove();
+    }
+
+    /**
+     * @brief Closes the files and deletes the directory, ignoring errors.
+     */
+    void Remove()
+    {
+        ids.reset();
+        moves.reset();
+        runs.reset();
+        std::error_code error;
+        std::filesystem::remove_all(root, error);
+    }
+};
+
+/**
+ * @brief Splits the budget: half for the successor buffer, the rest for the three cached levels.
+ */
+ExternalBfs::ExternalBfs(std::size_t memoryBytes, std::string _directory) : directory(std::move(_directory))
+{
+    if (memoryBytes < MinMemoryBytes)
+        throw std::invalid_argument("ExternalBfs: the memory budget must be at least " + std::to_string(MinMemoryBytes) + " bytes");
+
+    candidateCapacity = memoryBytes / 2 / sizeof(uint64_t);
+    levelCapacity = memoryBytes / 2 / 3 / sizeof(uint32_t);
+    blockBytes = std::min(BlockBytes, memoryBytes / 8);
+}
+
+/**
+ * @brief Creates the temporary files, runs the search and rebuilds the path; the files go away on return.
+ */
+ExternalBfs::Result ExternalBfs::Solve(int L, int S, int W)
+{
+    if (S < 0 || L <= S)
+        throw std::invalid_argument("ExternalBfs: capacities must satisfy 0 <= S < L");
+
+    Result result;
+    path.clear();
+    if (W < 0 || W > L)
+        return result;
+    if (W == 0)
+    {
+        result.solved = true;
+        return result;
+    }
+
+    SearchStats& stats = result.stats;
+    StateIndex states(L, S);
+    Files files(directory, blockBytes);
+
+    bool found;
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        found = Search(files, states, L, S, W, result);
+    }
+    if (found)
+    {
+        auto pathTimer = stats.Time(SearchPhase::Path);
+        RebuildPath(files, states, L, S, W);
+    }
+
+    result.solved = found;
+    result.operations = uint32_t(path.size());
+    result.moves = path;
+    result.bytesWritten = files.written;
+    result.bytesRead = files.read;
+    return result;
+}
+
+/**
+ * @brief Expands one level at a time until a level holds (W, 0) or comes out empty.
+ *
+ * Level t is in slot t % 3, so the slot of level t + 1 is the one of level t - 2, which is no
+ * longer needed.
+ */
+bool ExternalBfs::Search(Files& files, const StateIndex& states, int L, int S, int W, Result& result)
+{
+    SearchStats& stats = result.stats;
+    std::size_t before = MemoryBytes();
+    for (Level& level : slots)
+    {
+        level.offset = level.count = 0;
+        level.cached = true;
+        level.ids.clear();
+    }
+    early.clear();
+
+    // === Level 0 is (0, 0); its operation is never read ===
+    uint32_t goal = states.index(W, 0);
+    Append(files, slots[0], states.index(0, 0), Move::FillLarge);
+    early.push_back(states.index(0, 0));
+    uint32_t size = 1;
+    files.ids->Write(&size, sizeof(size));
+
+    for (uint32_t t = 0;; t++)
+    {
+        Level& previous = slots[(t + 2) % 3];
+        Level& current = slots[t % 3];
+        Level& next = slots[(t + 1) % 3];
+        result.levels = t + 1;
+
+        Expand(files, states, L, S, current, result);
+
+        next.offset = files.ids->size;
+        next.count = 0;
+        next.cached = true;
+        next.ids.clear();
+        bool found = Merge(files, previous, current, next, goal);
+
+        // === Close the level: its size goes after its states, for reading the file backwards ===
+        size = uint32_t(next.count);
+        files.ids->Write(&size, sizeof(size));
+        if (!next.cached)
+            files.ids->Flush();
+        if (t < 2)  // all of the level, even if it did not fit in memory
+        {
+            for (Stream<uint32_t> added = OpenLevel(files, next, levelCapacity); !added.Empty(); added.Pop())
+                early.push_back(added.Front());
+            std::sort(early.begin(), early.end());
+        }
+        stats.Queue(next.count);
+
+        if (found || next.count == 0)
+        {
+            stats.Allocate(MemoryBytes() - before);
+            return found;
+        }
+    }
+}
+
+/**
+ * @brief Applies the six operations to every state of the level, read from memory or from the index file.
+ */
+void ExternalBfs::Expand(Files& files, const StateIndex& states, int L, int S, Level& level, Result& result)
+{
+    candidates.clear();
+    runs.clear();
+    if (files.runs->size > 0)   // the runs of the last level are no longer needed
+        files.runs->Rewind();
+
+    Stream<uint32_t> frontier = OpenLevel(files, level, levelCapacity);
+
+    int toBig, toSmall;
+    for (; !frontier.Empty(); frontier.Pop())
+    {
+        auto [big, small] = states.state(frontier.Front());
+        result.stats.Expand();
+
+        for (int m = 0; m < MoveCount; m++)
+        {
+            if (!ApplyMove(Move(m), L, S, big, small, toBig, toSmall))
+                continue;
+
+            result.stats.Relax();
+            if (candidates.size() == candidateCapacity)
+                WriteRun(files, result);
+            candidates.push_back(uint64_t(states.index(toBig, toSmall)) << 3 | uint64_t(m));
+        }
+    }
+
+    if (runs.empty())
+        SortCandidates();
+    else if (!candidates.empty())
+        WriteRun(files, result);
+}
+
+/**
+ * @brief Walks the successors in order alongside the three sorted sets to subtract.
+ *
+ * When there are more runs than the buffer can read at once, groups of them are first merged
+ * into longer runs at the end of the run file.
+ */
+bool ExternalBfs::Merge(Files& files, Level& previous, Level& current, Level& next, uint32_t goal)
+{
+    Stream<uint32_t> older = OpenLevel(files, previous, levelCapacity);
+    Stream<uint32_t> same = OpenLevel(files, current, levelCapacity);
+    Stream<uint32_t> corners{ std::span<const uint32_t>(early) };
+    bool found = false;
+
+    auto emit = [&](uint64_t candidate)
+    {
+        uint32_t v = uint32_t(candidate >> 3);
+        if (older.Contains(v) || same.Contains(v) || corners.Contains(v))
+            return;
+        Append(files, next, v, Move(candidate & 7));
+        found = found || v == goal;
+    };
+
+    if (runs.empty())
+    {
+        for (uint64_t candidate : candidates)
+            emit(candidate);
+        return found;
+    }
+
+    // Each run read needs a share of the buffer of at least one block, or else two runs at a time
+    const std::size_t fanIn = std::max<std::size_t>(2, candidateCapacity * sizeof(uint64_t) / BlockBytes);
+    while (runs.size() > fanIn)
+    {
+        Run merged{ files.runs->size, 0 };
+        MergeRuns(files, fanIn, [&](uint64_t candidate)
+        {
+            files.runs->Write(&candidate, sizeof(candidate));
+            merged.count++;
+        });
+        runs.erase(runs.begin(), runs.begin() + fanIn);
+        runs.push_back(merged);
+    }
+    MergeRuns(files, runs.size(), emit);
+    return found;
+}
+
+/**
+ * @brief k-way merge with a heap, reading each run through an equal share of the buffer.
+ *
+ * Within a run every state appears once; across runs the heap yields the copies of a state
+ * together, the smallest operation first.
+ */
+template <typename Emit>
+void ExternalBfs::MergeRuns(Files& files, std::size_t count, Emit emit)
+{
+    files.runs->Flush();
+    candidates.resize(candidateCapacity);
+    std::size_t share = candidateCapacity / count;
+
+    std::vector<Stream<uint64_t>> inputs;
+    inputs.reserve(count);
+    using Head = std::pair<uint64_t, std::size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        inputs.emplace_back(files.runs->path, runs[i].offset, runs[i].count,
+            std::span<uint64_t>(candidates).subspan(i * share, share), files.read);
+        if (!inputs[i].Empty())
+            heads.push({ inputs[i].Front(), i });
+    }
+
+    uint64_t last = UINT64_MAX;
+    while (!heads.empty())
+    {
+        auto [candidate, i] = heads.top();
+        heads.pop();
+        if (candidate >> 3 != last)
+        {
+            emit(candidate);
+            last = candidate >> 3;
+        }
+
+        inputs[i].Pop();
+        if (!inputs[i].Empty())
+            heads.push({ inputs[i].Front(), i });
+    }
+}
+
+/**
+ * @brief Sorting by index << 3 | operation puts the copies of a state together, smallest operation first.
+ */
+void ExternalBfs::SortCandidates()
+{
+    std::sort(candidates.begin(), candidates.end());
+    auto end = std::unique(candidates.begin(), candidates.end(),
+        [](uint64_t a, uint64_t b) { return a >> 3 == b >> 3; });
+    candidates.erase(end, candidates.end());
+}
+
+void ExternalBfs::WriteRun(Files& files, Result& result)
+{
+    SortCandidates();
+    runs.push_back({ files.runs->size, candidates.size() });
+    files.runs->Write(candidates.data(), candidates.size() * sizeof(uint64_t));
+    candidates.clear();
+    result.runs++;
+}
+
+/**
+ * @brief Writes the state and its operation, and keeps the state in memory while the level fits.
+ */
+void ExternalBfs::Append(Files& files, Level& level, uint32_t v, Move move)
+{
+    files.ids->Write(&v, sizeof(v));
+    files.moves->Write(&move, sizeof(move));
+    level.count++;
+
+    if (level.cached && level.ids.size() < levelCapacity)
+        level.ids.push_back(v);
+    else
+        level.cached = false;
+}
+
+/**
+ * @brief Walks back from (W, 0) with InverseMove, finding each state in its level by binary search.
+ *
+ * A level ends with its size, so the level before one that starts at byte `begin` of the index
+ * file ends at `begin`; its operations end where the next level's operations start. The parent
+ * given by InverseMove is the BFS parent for the reason given there: the operation kept for a
+ * state is the smallest one from the level before, and the corners are reached within two levels.
+ */
+void ExternalBfs::RebuildPath(Files& files, const StateIndex& states, int L, int S, int W)
+{
+    files.ids->Flush();
+    files.moves->Flush();
+    BlockReader ids(files.ids->path, files.ids->size, blockBytes, files.read);
+    BlockReader moves(files.moves->path, files.moves->size, blockBytes, files.read);
+
+    uint64_t idsEnd = files.ids->size, movesEnd = files.moves->size;
+    uint32_t start = states.index(0, 0);
+    uint32_t v = states.index(W, 0);
+    int big = W, small = 0;
+
+    while (v != start)
+    {
+        // === Find v in the level that ends at idsEnd ===
+        uint32_t count;
+        ids.Read(idsEnd - sizeof(count), &count, sizeof(count));
+        uint64_t begin = idsEnd - sizeof(count) - uint64_t(count) * sizeof(uint32_t);
+        uint64_t movesBegin = movesEnd - count;
+
+        uint64_t lo = 0, hi = count;
+        while (lo < hi)
+        {
+            uint64_t mid = (lo + hi) / 2;
+            uint32_t id;
+            ids.Read(begin + mid * sizeof(id), &id, sizeof(id));
+            if (id < v)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        uint32_t found = StateIndex::npos;
+        if (lo < count)
+            ids.Read(begin + lo * sizeof(found), &found, sizeof(found));
+        if (found != v)
+            throw std::logic_error("ExternalBfs: a state of the path is missing from its level");
+
+        Move move;
+        moves.Read(movesBegin + lo, &move, sizeof(move));
+        path.push_back(move);
+        InverseMove(move, L, S, big, small, big, small);
+        v = states.index(big, small);
+
+        idsEnd = begin;
+        movesEnd = movesBegin;
+    }
+
+    std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "Common.h"
+#include "JugSolver.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include "SearchStats.h"
+
+/**
+ * @brief BFS for the two-jug problem that keeps the visited states on disk and works within a
+ * fixed memory budget.
+ *
+ * JugSolver keeps a visited bit and a 3-bit operation for every state, which for the largest
+ * capacities StateIndex supports comes to 2 GB. This solver keeps no per-state array: its
+ * memory is set by the budget, and the levels of the search live in files of a temporary
+ * directory that is removed when the query ends.
+ * - Every level is appended to an index file as its sorted state indices followed by its size,
+ *   and the operation that reached each state goes, in the same order, to an operation file.
+ * - The successors of a level are collected in a buffer as (index, operation) pairs. Whenever the
+ *   buffer is full it is sorted and written out as a run; the runs are then merged, in several
+ *   passes if there are more than the budget can read at once.
+ * - Duplicates are removed while merging, against the current and the previous level, which are
+ *   read in order from memory when they fit and from the index file otherwise (Munagala–Ranade).
+ *
+ * Subtracting two levels is exact in an undirected graph. The jug graph is directed, but the
+ * edges of the ring of reachable states (see AStarSolver) go both ways and every other edge
+ * starts or ends at a corner, so a successor of level t that is not a corner lies in level
+ * t - 1, t or t + 1. The corners are all visited by level 2, so the states of levels 0 to 2 are
+ * kept in memory as well and subtracted from every level.
+ *
+ * Files are written sequentially and read sequentially in blocks of up to BlockBytes. The path
+ * is rebuilt by reading the files backwards, one level at a time, from the goal to (0, 0).
+ *
+ * A level holds at most four states plus the corners, so no practical budget ever spills. The
+ * smallest one, MinMemoryBytes, holds 2 successors and 1 state per level: every level then
+ * writes runs, merges them in several passes and is streamed from the index file, which is
+ * what `Ex1 --external L S W --memory-bytes 32 --check` exercises.
+ */
+class ExternalBfs
+{
+public:
+
+    static constexpr std::size_t DefaultMemoryBytes = std::size_t(256) << 20;  ///< Default budget
+    static constexpr std::size_t MinMemoryBytes = 32;           ///< Smallest budget accepted
+    static constexpr std::size_t BlockBytes = 1 << 20;          ///< Largest unit of file I/O
+
+    /**
+     * @brief Outcome of one query, with the I/O it took.
+     */
+    struct Result : JugSolver::Result
+    {
+        uint32_t levels = 0;            ///< Levels expanded
+        uint64_t runs = 0;              ///< Sorted runs written because a level's successors did not fit the buffer
+        uint64_t bytesWritten = 0;      ///< Bytes written to the temporary files
+        uint64_t bytesRead = 0;         ///< Bytes read back from them
+    };
+
+    /**
+     * @brief Creates a solver.
+     *
+     * @param memoryBytes Budget for the successor buffer and the cached levels; each open file
+     *                    also holds one I/O block of up to BlockBytes
+     * @param directory Directory in which each query creates its temporary directory
+     *                  (the system's temporary directory if empty)
+     * @throws std::invalid_argument if the budget is below MinMemoryBytes
+     */
+    explicit ExternalBfs(std::size_t memoryBytes = DefaultMemoryBytes, std::string directory = "");
+
+    /**
+     * @brief Finds a shortest sequence of operations from (0, 0) to (W, 0).
+     *
+     * @param L Capacity of the large jug
+     * @param S Capacity of the small jug, 0 <= S < L
+     * @param W Target amount in the large jug
+     * @throws std::invalid_argument if the capacities are out of range
+     * @throws std::runtime_error if a temporary file cannot be created, written or read
+     */
+    Result Solve(int L, int S, int W);
+
+    /**
+     * @brief Memory currently held by the buffers, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        std::size_t bytes = candidates.capacity() * sizeof(uint64_t) + path.capacity() * sizeof(Move);
+        for (const Level& level : slots)
+            bytes += level.ids.capacity() * sizeof(uint32_t);
+        return bytes + early.capacity() * sizeof(uint32_t) + runs.capacity() * sizeof(Run);
+    }
+
+private:
+
+    struct Files;   ///< The temporary files of one query
+
+    /**
+     * @brief A level of the search: its place in the index file, and its states if they fit in memory.
+     */
+    struct Level
+    {
+        uint64_t offset = 0;            ///< Byte offset of the first state in the index file
+        uint64_t count = 0;             ///< Number of states
+        bool cached = true;             ///< true if `ids` holds all the states
+        std::vector<uint32_t> ids;      ///< The states in order if cached, else a read buffer
+    };
+
+    /**
+     * @brief A sorted run of successors in the run file.
+     */
+    struct Run
+    {
+        uint64_t offset;                ///< Byte offset of the first successor
+        uint64_t count;                 ///< Number of successors
+    };
+
+    std::string directory;              ///< Parent of the temporary directories
+    std::size_t candidateCapacity;      ///< Successors the buffer may hold
+    std::size_t levelCapacity;          ///< States a cached level may hold
+    std::size_t blockBytes;             ///< Unit of file I/O
+
+    Level slots[3];                     ///< The previous, current and next level, by level % 3
+    std::vector<uint64_t> candidates;   ///< Successors of the current level, as index << 3 | operation
+    std::vector<Run> runs;              ///< Runs written for the current level
+    std::vector<uint32_t> early;        ///< States of levels 0 to 2, sorted
+    std::vector<Move> path;             ///< Moves of the last solution
+
+    /**
+     * @brief Level-synchronous BFS from (0, 0), stopping after the level that reaches (W, 0).
+     *
+     * @return true if (W, 0) was reached
+     */
+    bool Search(Files& files, const StateIndex& states, int L, int S, int W, Result& result);
+
+    /**
+     * @brief Collects the successors of `level` in the buffer, writing a run whenever it fills up.
+     */
+    void Expand(Files& files, const StateIndex& states, int L, int S, Level& level, Result& result);
+
+    /**
+     * @brief Writes the successors of `current` that are not in `previous`, `current` or `early` to `next`.
+     *
+     * @return true if `goal` is one of them
+     */
+    bool Merge(Files& files, Level& previous, Level& current, Level& next, uint32_t goal);
+
+    /**
+     * @brief Merges the first `count` runs, passing each state once (with its smallest operation) to `emit`.
+     */
+    template <typename Emit>
+    void MergeRuns(Files& files, std::size_t count, Emit emit);
+
+    /**
+     * @brief Sorts the buffer and keeps the first successor of each state.
+     */
+    void SortCandidates();
+
+    /**
+     * @brief Sorts the buffer and writes it to the run file.
+     */
+    void WriteRun(Files& files, Result& result);
+
+    /**
+     * @brief Appends a state and the operation that reached it to `level`.
+     */
+    void Append(Files& files, Level& level, uint32_t v, Move move);
+
+    /**
+     * @brief Fills `path` with the moves from (0, 0) to (W, 0), reading the levels backwards.
+     */
+    void RebuildPath(Files& files, const StateIndex& states, int L, int S, int W);
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include <array>
+
+/**
+ * @brief Two-jug solver for capacities known at compile time, answering every query from static tables.
+ *
+ * The BFS from (0, 0), the minimum number of operations for every target W and the move list
+ * of a shortest solution for every W are all computed in constant expressions and stored as
+ * static constexpr arrays, which end up in read-only data. A query is a table lookup that
+ * returns a view of its stored move list: no startup work, no heap, no search at run time.
+ *
+ * The BFS generates neighbors with ForEachNeighbor, the transition rule Graph::generateAllEdges
+ * uses, so the moves are the ones Way1 returns.
+ *
+ * The move lists of all targets take about L^2 / 2 bytes at most, and the compiler evaluates
+ * every step of the BFS, so this is meant for small capacities. Large ones may need the
+ * compiler's constant evaluation limit raised (-fconstexpr-ops-limit, -fconstexpr-steps or
+ * /constexpr:steps). Solver<N> is the unrelated run-time solver for N jugs.
+ */
+template <int L, int S>
+class FixedSolver
+{
+    static_assert(0 <= S && S < L, "FixedSolver: capacities must satisfy 0 <= S < L");
+
+public:
+
+    static constexpr uint32_t Unreachable = UINT32_MAX;  ///< Operations of an unreachable target
+
+    /**
+     * @brief Outcome of one query. `moves` points into static storage and stays valid forever.
+     */
+    struct Result
+    {
+        bool solved = false;            ///< true if (W, 0) is reachable from (0, 0)
+        uint32_t operations = 0;        ///< Minimum number of operations (0 if not solved)
+        std::span<const Move> moves;    ///< The operations of a shortest solution, in order
+    };
+
+    /**
+     * @brief Returns a shortest sequence of operations from (0, 0) to (W, 0), looked up in the tables.
+     */
+    static constexpr Result Solve(int W)
+    {
+        Result result;
+        if (!Solvable(W))
+            return result;
+
+        result.solved = true;
+        result.moves = Path(W);
+        result.operations = uint32_t(result.moves.size());
+        return result;
+    }
+
+    /**
+     * @brief Returns the minimum number of operations to reach (W, 0), or Unreachable.
+     */
+    static constexpr uint32_t MinOperations(int W)
+    {
+        return (W < 0 || W > L) ? Unreachable : distances[W];
+    }
+
+    /**
+     * @brief Returns true if (W, 0) is reachable from (0, 0).
+     */
+    static constexpr bool Solvable(int W) { return MinOperations(W) != Unreachable; }
+
+    /**
+     * @brief Returns the operations of a shortest solution for W, in order; empty if W = 0 or there is no solution.
+     */
+    static constexpr std::span<const Move> Path(int W)
+    {
+        if (!Solvable(W))
+            return {};
+        return std::span<const Move>(paths.data() + offsets[W], distances[W]);
+    }
+
+private:
+
+    static constexpr StateIndex states{ L, S };     ///< Dense numbering of the boundary states
+    static constexpr uint32_t n = states.size();    ///< Number of boundary states
+
+    /**
+     * @brief Result of the BFS over all reachable states, indexed by StateIndex.
+     */
+    struct Search
+    {
+        std::array<uint32_t, n> dist{};     ///< Distance from (0, 0), or Unreachable
+        std::array<Move, n> via{};          ///< Operation that leads from the parent to the state
+    };
+
+    /**
+     * @brief Complete BFS from (0, 0) with a flat queue, as in JugSolver.
+     */
+    static constexpr Search Bfs()
+    {
+        Search search;
+        std::array<uint32_t, n> Q{};
+        std::size_t tail = 0;
+        for (uint32_t& d : search.dist)
+            d = Unreachable;
+
+        uint32_t start = states.index(0, 0);
+        search.dist[start] = 0;
+        Q[tail++] = start;
+
+        for (std::size_t head = 0; head < tail; head++)
+        {
+            uint32_t U = Q[head];
+            ForEachNeighbor(states, L, S, U, [&](Move move, uint32_t V)
+            {
+                if (search.dist[V] == Unreachable)
+                {
+                    search.dist[V] = search.dist[U] + 1;
+                    search.via[V] = move;
+                    Q[tail++] = V;
+                }
+            });
+        }
+        return search;
+    }
+
+    static constexpr Search search = Bfs();     ///< Only used to build the tables below
+
+    /**
+     * @brief Minimum number of operations for every target W in [0, L].
+     */
+    static constexpr std::array<uint32_t, L + 1> Distances()
+    {
+        std::array<uint32_t, L + 1> result{};
+        for (int W = 0; W <= L; W++)
+            result[W] = search.dist[states.index(W, 0)];
+        return result;
+    }
+
+    static constexpr std::array<uint32_t, L + 1> distances = Distances();
+
+    /**
+     * @brief Start of the move list of every target in `paths`; entry L + 1 is the total length.
+     */
+    static constexpr std::array<std::size_t, L + 2> Offsets()
+    {
+        std::array<std::size_t, L + 2> result{};
+        for (int W = 0; W <= L; W++)
+            result[W + 1] = result[W] + (distances[W] == Unreachable ? 0 : distances[W]);
+        return result;
+    }
+
+    static constexpr std::array<std::size_t, L + 2> offsets = Offsets();
+
+    /**
+     * @brief The move lists of all targets, end to end, each read back from (W, 0) with InverseMove.
+     */
+    static constexpr std::array<Move, offsets[L + 1]> Paths()
+    {
+        std::array<Move, offsets[L + 1]> result{};
+        for (int W = 0; W <= L; W++)
+        {
+            if (distances[W] == Unreachable)
+                continue;
+
+            int big = W, small = 0;
+            for (std::size_t i = offsets[W] + distances[W]; i > offsets[W]; i--)
+            {
+                result[i - 1] = search.via[states.index(big, small)];
+                InverseMove(result[i - 1], L, S, big, small, big, small);
+            }
+        }
+        return result;
+    }
+
+    static constexpr std::array<Move, offsets[L + 1]> paths = Paths();
+};
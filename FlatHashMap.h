@@ -0,0 +1,147 @@
+#pragma once
+#include "Common.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Open-addressing hash map from packed 64-bit states to 64-bit values.
+ *
+ * All slots live in one flat array and collisions are resolved by linear probing,
+ * so an insert costs no allocation (apart from the occasional doubling) and a lookup
+ * touches one or two cache lines. Keys are scrambled with the splitmix64 finalizer,
+ * which spreads the small, regular coordinates of jug states over the whole table.
+ *
+ * The key UINT64_MAX is reserved to mark empty slots.
+ */
+class FlatHashMap
+{
+public:
+
+    static constexpr uint64_t EmptyKey = UINT64_MAX;   ///< Marks an unused slot
+
+    /**
+     * @brief Creates an empty map with room for `expected` keys before the first growth.
+     */
+    explicit FlatHashMap(std::size_t expected = 16)
+    {
+        std::size_t capacity = 16;
+        while (capacity < expected * 2)
+            capacity *= 2;
+        slots.assign(capacity, { EmptyKey, 0 });
+        mask = capacity - 1;
+    }
+
+    /**
+     * @brief Number of keys stored.
+     */
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief Inserts (key, value) unless the key is already present.
+     *
+     * @return true if the key was inserted, false if it was already present (its value is kept)
+     */
+    bool InsertIfAbsent(uint64_t key, uint64_t value)
+    {
+        if ((count + 1) * 2 > slots.size())
+            Grow();
+
+        for (std::size_t i = Mix(key) & mask;; i = (i + 1) & mask)
+        {
+            stats.Probe();
+            if (slots[i].key == key)
+                return false;
+            if (slots[i].key == EmptyKey)
+            {
+                slots[i] = { key, value };
+                count++;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns a pointer to the value of a key, or nullptr if it is absent.
+     */
+    const uint64_t* Find(uint64_t key) const
+    {
+        for (std::size_t i = Mix(key) & mask;; i = (i + 1) & mask)
+        {
+            stats.Probe();
+            if (slots[i].key == key)
+                return &slots[i].value;
+            if (slots[i].key == EmptyKey)
+                return nullptr;
+        }
+    }
+
+    /**
+     * @brief Returns true if the key is present.
+     */
+    bool Contains(uint64_t key) const { return Find(key) != nullptr; }
+
+    /**
+     * @brief Memory used by the slots, in bytes.
+     */
+    std::size_t MemoryBytes() const { return slots.size() * sizeof(Slot); }
+
+    /**
+     * @brief Slots inspected by lookups and inserts so far (zero unless JUG_STATS is set).
+     */
+    const SearchStats& Stats() const { return stats; }
+
+    /**
+     * @brief Removes all keys, keeping the allocated slots.
+     */
+    void Clear()
+    {
+        std::fill(slots.begin(), slots.end(), Slot{ EmptyKey, 0 });
+        count = 0;
+    }
+
+private:
+
+    struct Slot
+    {
+        uint64_t key;
+        uint64_t value;
+    };
+
+    std::vector<Slot> slots;    ///< Power-of-two number of slots, at most half full
+    std::size_t mask;           ///< slots.size() - 1
+    std::size_t count = 0;      ///< Number of keys stored
+    mutable SearchStats stats;  ///< Probe counter, also updated by const lookups
+
+    /**
+     * @brief splitmix64 finalizer: every input bit affects every output bit.
+     */
+    static uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /**
+     * @brief Doubles the number of slots and reinserts every key.
+     */
+    void Grow()
+    {
+        std::vector<Slot> old(slots.size() * 2, Slot{ EmptyKey, 0 });
+        old.swap(slots);
+        mask = slots.size() - 1;
+
+        for (const Slot& slot : old)
+        {
+            if (slot.key == EmptyKey)
+                continue;
+
+            std::size_t i = Mix(slot.key) & mask;
+            while (slots[i].key != EmptyKey)
+                i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+};
@@ -1,143 +1,107 @@
-#include "Graph.h"
-#include "Common.h"
-
-/**
- * @brief Initializes all possible states of the jugs (vertices) and stores them in the graph.
- *
- * Each state is represented as a pair (big, small), where:
- * - big = amount in the large jug
- * - small = amount in the small jug
- *
- * The total number of vertices is (L + 1) * (S + 1).
- * The vertices are stored in row-major order in the `vertices` vector.
- */
-void Graph::MakeEmptyGraph(int n)
-{
-    vertices.reserve(n);
-    for (int i = 0; i < n; i++)
-    {
-        int big = i / (S + 1);            // integer division: row
-        int small = i % (S + 1);      // remainder: column
-        vertices.push_back(new VertexNode({ big, small }));
-    }
-}
-
-/**
- * @brief Finds and returns a pointer to the vertex representing the given state.
- *
- * @param vertex The target state (big, small)
- * @return Pointer to the corresponding VertexNode, or nullptr if out of bounds.
- */
-Graph::VertexNode* Graph::findVertex(std::pair<int, int> vertex)
-{
-    int big = vertex.first;
-    int small = vertex.second;
-
-    if (big < 0 || big > L || small < 0 || small > S)
-        return nullptr; // invalid state
-
-    int index = big * (S + 1) + small;
-    return vertices[index];
-}
-
-/**
- * @brief Adds a directed edge between two states in the graph.
- *
- * @param from Origin state
- * @param to Destination state
- */
-void Graph::addEdge(std::pair<int, int> from, std::pair<int, int> to)
-{
-    VertexNode* fromNode = findVertex(from);
-    if (fromNode)
-        fromNode->neighbors.push_back(to);
-}
-
-/**
- * @brief Generates all legal transitions (edges) between states in the water jug problem.
- *
- * For each state (big, small), applies all valid operations:
- * - Fill large jug
- * - Fill small jug
- * - Empty large jug
- * - Empty small jug
- * - Transfer from large to small
- * - Transfer from small to large
- *
- * Neighbor lists are sorted in lexicographic order after all edges are added.
- */
-void Graph::generateAllEdges()
-{
-    for (auto v : vertices)
-    {
-        int big = v->data.first;
-        int small = v->data.second;
-
-        // 1. Fill large jug
-        if (big < L)
-            addEdge({ big, small }, { L, small });
-
-        // 2. Fill small jug
-        if (small < S)
-            addEdge({ big, small }, { big, S });
-
-        // 3. Empty large jug
-        if (big > 0)
-            addEdge({ big, small }, { 0, small });
-
-        // 4. Empty small jug
-        if (small > 0)
-            addEdge({ big, small }, { big, 0 });
-
-        // 5. Transfer from large to small
-        if (big > 0 && small < S)
-        {
-            int pour = std::min(big, S - small);
-            addEdge({ big, small }, { big - pour, small + pour });
-        }
-
-        // 6. Transfer from small to large
-        if (small > 0 && big < L)
-        {
-            int pour = std::min(small, L - big);
-            addEdge({ big, small }, { big + pour, small - pour });
-        }
-
-        // Sort neighbors in lexicographic order
-        v->neighbors.sort();
-    }
-}
-
-/**
- * @brief Prints the graph's adjacency list for all states.
- *
- * For each vertex, prints the state and its sorted neighbors.
- */
-void Graph::printGraph() const
-{
-    for (const auto& v : vertices)
-    {
-        std::cout << "(" << v->data.first << ", " << v->data.second << ") -> ";
-        for (const auto& n : v->neighbors)
-            std::cout << "(" << n.first << ", " << n.second << ") ";
-        std::cout << std::endl;
-    }
-}
-
-/**
- * @brief Returns the sorted list of neighbors for a given state.
- *
- * @param u The state (big, small)
- * @return Sorted list of adjacent states (legal next moves)
- */
-std::list<std::pair<int, int>> Graph::GetAdjList(std::pair<int, int> u) const
-{
-    int big = u.first;
-    int small = u.second;
-
-    if (big < 0 || big > L || small < 0 || small > S)
-        return {}; // invalid state
-
-    int index = big * (S + 1) + small;
-    return vertices[index]->neighbors; // already sorted
-}
+#include "Graph.h"
+#include "Common.h"
+#include "Move.h"
+
+/**
+ * @brief Allocates the offsets array for all possible states of the jugs (vertices).
+ *
+ * Each reachable state is represented by its StateIndex index.
+ * The total number of vertices is 2 * (L + S), one per boundary state.
+ */
+void Graph::MakeEmptyGraph(uint32_t n)
+{
+    offsets.assign(size_t(n) + 1, 0);
+    targets.clear();
+    moves.clear();
+}
+
+/**
+ * @brief Finds and returns the index of the vertex representing the given state.
+ *
+ * @param vertex The target state (big, small)
+ * @return Index of the corresponding vertex, or npos if out of bounds or unreachable.
+ */
+uint32_t Graph::findVertex(std::pair<int, int> vertex) const
+{
+    return states.index(vertex.first, vertex.second);
+}
+
+/**
+ * @brief Applies all valid operations to a state and reports each resulting state in index
+ * order (fill, empty and transfer for both jugs, see ApplyMove and ForEachNeighbor).
+ */
+template <typename Emit>
+void Graph::forEachMove(uint32_t v, Emit emit) const
+{
+    ForEachNeighbor(states, L, S, v, emit);
+}
+
+/**
+ * @brief Generates all legal transitions (edges) between states in the water jug problem.
+ *
+ * The CSR arrays are built in two passes: the first counts the out-degree of every
+ * vertex and turns the counts into offsets, the second writes the targets in place.
+ *
+ * Every operation leaves a jug full or empty, so all targets are boundary states.
+ *
+ * Neighbor lists are in lexicographic order, with the operation behind each edge stored
+ * alongside it in `moves`: forEachMove reports the neighbors sorted by index, and StateIndex
+ * numbers states in lexicographic order.
+ */
+void Graph::generateAllEdges()
+{
+    // === Pass 1: count out-degrees ===
+    for (uint32_t v = 0; v < n; v++)
+        forEachMove(v, [&](Move, uint32_t) { offsets[v + 1]++; });
+
+    for (uint32_t v = 0; v < n; v++)
+        offsets[v + 1] += offsets[v];
+
+    // === Pass 2: write targets and their operations ===
+    targets.resize(offsets[n]);
+    moves.resize(offsets[n]);
+    for (uint32_t v = 0; v < n; v++)
+    {
+        uint32_t i = offsets[v];
+        forEachMove(v, [&](Move move, uint32_t to)
+            {
+                targets[i] = to;
+                moves[i++] = move;
+            });
+    }
+}
+
+/**
+ * @brief Prints the graph's adjacency list for all states.
+ *
+ * For each vertex, prints the state and its sorted neighbors.
+ */
+void Graph::printGraph() const
+{
+    for (uint32_t v = 0; v < n; v++)
+    {
+        auto [big, small] = GetState(v);
+        std::cout << "(" << big << ", " << small << ") -> ";
+        for (uint32_t to : GetAdjList(v))
+        {
+            auto [toBig, toSmall] = GetState(to);
+            std::cout << "(" << toBig << ", " << toSmall << ") ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * @brief Returns the sorted neighbors of a given state.
+ *
+ * @param u The state (big, small)
+ * @return View of the indices of adjacent states (legal next moves)
+ */
+std::span<const uint32_t> Graph::GetAdjList(std::pair<int, int> u) const
+{
+    uint32_t v = findVertex(u);
+    if (v == npos)
+        return {}; // invalid state
+
+    return GetAdjList(v); // already sorted
+}
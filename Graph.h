@@ -1,102 +1,148 @@
-#pragma once
-#include "Common.h"
-
-/**
- * @brief A directed graph representing all possible states and transitions in the water jug problem.
- *
- * The graph stores all vertices (states) using a vector for fast indexed access,
- * and uses a linked list to represent the adjacency list (outgoing edges) of each vertex.
- */
-class Graph
-{
-public:
-
-    /**
-     * @brief Represents a single vertex in the graph.
-     *
-     * Each vertex holds a state as a pair of integers (big jug, small jug),
-     * and a list of neighboring vertices reachable by one legal operation.
-     */
-    struct VertexNode
-    {
-        std::pair<int, int> data;                   ///< The state: (amount in big jug, amount in small jug)
-        std::list<std::pair<int, int>> neighbors;   ///< List of adjacent vertices (possible next states)
-
-        VertexNode(std::pair<int, int> d) : data(d) {}
-    };
-
-    int L, S;  ///< Maximum capacities of the large and small jugs
-
-    /**
-     * @brief Vector of pointers to all vertices in the graph.
-     *
-     * The vertices are stored in row-major order:
-     * index = big * (S + 1) + small
-     */
-    std::vector<VertexNode*> vertices;
-
-    /**
-     * @brief Constructs the graph by generating all possible vertices and legal transitions (edges).
-     *
-     * @param _L Capacity of the large jug
-     * @param _S Capacity of the small jug
-     */
-    Graph(int _L, int _S) : L(_L), S(_S)
-    {
-        int n = (L + 1) * (S + 1);
-        MakeEmptyGraph(n);     // Create all vertices
-        generateAllEdges();    // Connect them with legal moves
-    }
-
-    /**
-     * @brief Destructor - releases all dynamically allocated vertex nodes.
-     */
-    ~Graph()
-    {
-        for (auto v : vertices)
-            delete v;
-    }
-
-    /**
-     * @brief Initializes the graph with all possible states (vertices), without edges.
-     *
-     * @param n Total number of vertices = (L + 1) * (S + 1)
-     */
-    void MakeEmptyGraph(int n);
-
-    /**
-     * @brief Returns a pointer to the vertex representing the given state.
-     *
-     * @param vertex The state (big, small)
-     * @return Pointer to the corresponding VertexNode, or nullptr if out of bounds.
-     */
-    VertexNode* findVertex(std::pair<int, int> vertex);
-
-    /**
-     * @brief Adds a directed edge from one state to another.
-     *
-     * @param from Origin vertex (state)
-     * @param to Destination vertex (state)
-     */
-    void addEdge(std::pair<int, int> from, std::pair<int, int> to);
-
-    /**
-     * @brief Generates all legal transitions (edges) for the water jug problem.
-     *
-     * Includes fill, empty, and transfer operations, and sorts each neighbor list lexicographically.
-     */
-    void generateAllEdges();
-
-    /**
-     * @brief Prints the entire graph: all vertices and their sorted neighbor lists.
-     */
-    void printGraph() const;
-
-    /**
-     * @brief Returns the sorted adjacency list of a given vertex (state).
-     *
-     * @param u The vertex state (big, small)
-     * @return A list of adjacent states reachable from u, sorted lexicographically.
-     */
-    std::list<std::pair<int, int>> GetAdjList(std::pair<int, int> u) const;
-};
+#pragma once
+#include "Common.h"
+#include "StateIndex.h"
+#include "Move.h"
+#include <memory_resource>
+
+/**
+ * @brief A directed graph representing all possible states and transitions in the water jug problem.
+ *
+ * The graph is stored in compressed sparse row (CSR) form: one contiguous array of
+ * offsets (one entry per vertex, plus a sentinel) and one contiguous array of target
+ * vertex indices. The neighbors of vertex v are targets[offsets[v] .. offsets[v + 1]).
+ * No memory is allocated per vertex.
+ *
+ * Only the states on the boundary of the grid are stored (see StateIndex), since
+ * no other state is reachable from (0, 0).
+ *
+ * The three arrays take their memory from a std::pmr::memory_resource chosen at construction,
+ * e.g. a GraphArena that keeps its blocks from one graph to the next.
+ */
+class Graph
+{
+public:
+
+    static constexpr uint32_t npos = StateIndex::npos;  ///< Returned by findVertex for an invalid state
+
+    int L, S;           ///< Maximum capacities of the large and small jugs
+    StateIndex states;  ///< Maps boundary states to vertex indices
+    uint32_t n;         ///< Number of vertices = 2 * (L + S)
+
+    /**
+     * @brief Start of each vertex's neighbor range in `targets` (size n + 1).
+     *
+     * The vertices are numbered by StateIndex, in lexicographic order of their states.
+     */
+    std::pmr::vector<uint32_t> offsets;
+
+    /**
+     * @brief Indices of adjacent vertices, grouped by origin vertex and sorted lexicographically.
+     */
+    std::pmr::vector<uint32_t> targets;
+
+    /**
+     * @brief The operation behind each edge, parallel to `targets`.
+     */
+    std::pmr::vector<Move> moves;
+
+    /**
+     * @brief Constructs the graph by generating all possible vertices and legal transitions (edges).
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @param resource Source of the memory of the arrays, which must outlive the graph
+     * @throws std::length_error if the state space does not fit 32-bit indices
+     */
+    Graph(int _L, int _S, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : L(_L), S(_S), states(_L, _S), offsets(resource), targets(resource), moves(resource)
+    {
+        if (uint64_t(states.size()) * 6 >= npos)
+            throw std::length_error("Graph: state space too large for 32-bit indices");
+
+        n = states.size();
+        MakeEmptyGraph(n);     // Create all vertices
+        generateAllEdges();    // Connect them with legal moves
+    }
+
+    /**
+     * @brief Initializes the graph with all possible states (vertices), without edges.
+     *
+     * @param n Total number of vertices = 2 * (L + S)
+     */
+    void MakeEmptyGraph(uint32_t n);
+
+    /**
+     * @brief Returns the index of the vertex representing the given state.
+     *
+     * @param vertex The state (big, small)
+     * @return Index of the corresponding vertex, or npos if out of bounds or unreachable.
+     */
+    uint32_t findVertex(std::pair<int, int> vertex) const;
+
+    /**
+     * @brief Returns the state represented by a vertex index.
+     *
+     * @param v Vertex index
+     * @return The state (big, small)
+     */
+    std::pair<int, int> GetState(uint32_t v) const
+    {
+        return states.state(v);
+    }
+
+    /**
+     * @brief Generates all legal transitions (edges) for the water jug problem.
+     *
+     * Includes fill, empty, and transfer operations, and sorts each neighbor list lexicographically.
+     */
+    void generateAllEdges();
+
+    /**
+     * @brief Prints the entire graph: all vertices and their sorted neighbor lists.
+     */
+    void printGraph() const;
+
+    /**
+     * @brief Memory used by the CSR arrays, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        return offsets.size() * sizeof(uint32_t) + targets.size() * sizeof(uint32_t) + moves.size() * sizeof(Move);
+    }
+
+    /**
+     * @brief Returns the sorted adjacency list of a given vertex.
+     *
+     * @param v The vertex index
+     * @return A view of the indices of adjacent vertices, sorted lexicographically.
+     */
+    std::span<const uint32_t> GetAdjList(uint32_t v) const
+    {
+        return { targets.data() + offsets[v], targets.data() + offsets[v + 1] };
+    }
+
+    /**
+     * @brief Returns the operations behind the edges of GetAdjList(v), in the same order.
+     */
+    std::span<const Move> GetAdjMoves(uint32_t v) const
+    {
+        return { moves.data() + offsets[v], moves.data() + offsets[v + 1] };
+    }
+
+    /**
+     * @brief Returns the sorted adjacency list of a given vertex (state).
+     *
+     * @param u The vertex state (big, small)
+     * @return A view of the indices of adjacent vertices, or an empty view for an invalid state.
+     */
+    std::span<const uint32_t> GetAdjList(std::pair<int, int> u) const;
+
+private:
+
+    /**
+     * @brief Calls `emit` with the operation and the index of every state reachable from v
+     * by one legal operation, in index order (see ForEachNeighbor).
+     */
+    template <typename Emit>
+    void forEachMove(uint32_t v, Emit emit) const;
+};
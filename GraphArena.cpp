@@ -0,0 +1,74 @@
+#include "GraphArena.h"
+#include "Common.h"
+#include <new>
+
+GraphArena::~GraphArena()
+{
+    for (const Block& block : blocks)
+        ::operator delete(block.data, block.size, std::align_val_t(BlockAlignment));
+}
+
+GraphArena& GraphArena::ThreadLocal()
+{
+    thread_local GraphArena arena;
+    return arena;
+}
+
+/**
+ * @brief Bumps the pointer of the current block, or starts a new block twice as large (at least).
+ */
+void* GraphArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    // Offset in the last block of the first byte at or after `offset` with the requested alignment
+    auto aligned = [&](std::size_t offset)
+    {
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(blocks.back().data) + offset;
+        return offset + (alignment - address % alignment) % alignment;
+    };
+
+    std::size_t start = 0;
+    if (blocks.empty() || (start = aligned(used)) + bytes > blocks.back().size)
+    {
+        std::size_t previous = blocks.empty() ? 0 : blocks.back().size;
+        AddBlock(std::max({ MinBlockBytes, bytes + alignment, 2 * previous }));
+        start = aligned(0);
+    }
+
+    used = start + bytes;
+    roundBytes += bytes + alignment;
+    live++;
+    return blocks.back().data + start;
+}
+
+/**
+ * @brief Memory is only reclaimed all at once, when the last allocation is released.
+ */
+void GraphArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+    if (--live == 0)
+        Rewind();
+}
+
+void GraphArena::AddBlock(std::size_t size)
+{
+    size = (size + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+    auto* data = static_cast<std::byte*>(::operator new(size, std::align_val_t(BlockAlignment)));
+    blocks.push_back({ data, size });
+    used = 0;
+}
+
+/**
+ * @brief Keeps a single block: the current one if the round fit in it, else a new one sized for the round.
+ */
+void GraphArena::Rewind()
+{
+    if (blocks.size() > 1)
+    {
+        for (const Block& block : blocks)
+            ::operator delete(block.data, block.size, std::align_val_t(BlockAlignment));
+        blocks.clear();
+        AddBlock(roundBytes);
+    }
+    used = 0;
+    roundBytes = 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "Common.h"
+#include <memory_resource>
+
+/**
+ * @brief Monotonic memory resource that serves a Graph's arrays from large retained blocks.
+ *
+ * An allocation bumps a pointer in the current block; a deallocation only counts down the live
+ * allocations, and when the last one is released the arena rewinds to the start of its block.
+ * Nothing is returned to the system while the arena lives. When a round (from the first
+ * allocation to the last release) needed more than one block, the blocks are replaced at rewind
+ * by a single block large enough for the whole round. A sequence of similar graphs thus settles
+ * on one block whose pages are already mapped, so building a graph neither maps nor faults in
+ * fresh memory and destroying it frees nothing.
+ *
+ * Not thread-safe; ThreadLocal() gives one arena per thread.
+ */
+class GraphArena : public std::pmr::memory_resource
+{
+public:
+
+    static constexpr std::size_t MinBlockBytes = 1 << 16;   ///< Size of the first block
+    static constexpr std::size_t BlockAlignment = 64;       ///< Alignment of every block (a cache line)
+
+    GraphArena() = default;
+    GraphArena(const GraphArena&) = delete;
+    GraphArena& operator=(const GraphArena&) = delete;
+
+    /**
+     * @brief Returns the blocks to the system. Every allocation must have been released.
+     */
+    ~GraphArena() override;
+
+    /**
+     * @brief Returns the arena of the calling thread.
+     */
+    static GraphArena& ThreadLocal();
+
+    /**
+     * @brief Memory held by the blocks, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        std::size_t bytes = 0;
+        for (const Block& block : blocks)
+            bytes += block.size;
+        return bytes;
+    }
+
+private:
+
+    /**
+     * @brief One block obtained from the system.
+     */
+    struct Block
+    {
+        std::byte* data;    ///< First byte, BlockAlignment-aligned
+        std::size_t size;   ///< Size in bytes
+    };
+
+    std::vector<Block> blocks;      ///< Blocks of the current round; the last one is being filled
+    std::size_t used = 0;           ///< Bytes used in the last block
+    std::size_t roundBytes = 0;     ///< Bytes requested in this round, alignment padding included
+    std::size_t live = 0;           ///< Allocations not yet released
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    /**
+     * @brief Adds a block of at least `size` bytes and makes it the current one.
+     */
+    void AddBlock(std::size_t size);
+
+    /**
+     * @brief Starts a new round once every allocation has been released.
+     */
+    void Rewind();
+};
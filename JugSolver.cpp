@@ -0,0 +1,88 @@
+#include "JugSolver.h"
+#include "Common.h"
+
+/**
+ * @brief Prepares the pooled buffers, then runs the search and rebuilds the path.
+ */
+JugSolver::Result JugSolver::Solve(int L, int S, int W)
+{
+    if (S < 0 || L <= S)
+        throw std::invalid_argument("JugSolver: capacities must satisfy 0 <= S < L");
+
+    Result result;
+    if (W < 0 || W > L)
+        return result;
+
+    SearchStats& stats = result.stats;
+    StateIndex states(L, S);
+    uint32_t n = states.size();
+
+    // === Prepare the pooled buffers (no allocation unless n is a new maximum) ===
+    {
+        auto buildTimer = stats.Time(SearchPhase::Build);
+        std::size_t before = MemoryBytes();
+        visited.Reset(n);
+        via.Reserve(n);
+        queue.clear();
+        queue.reserve(n);
+        stats.Allocate(MemoryBytes() - before);
+    }
+
+    bool found;
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        found = Search(states, L, S, W, stats);
+    }
+    if (!found)
+        return result;
+
+    {
+        auto pathTimer = stats.Time(SearchPhase::Path);
+        RebuildPath(L, S, W, [&](int big, int small) { return via.Get(states.index(big, small)); }, path);
+    }
+
+    result.solved = true;
+    result.operations = uint32_t(path.size());
+    result.moves = path;
+    return result;
+}
+
+/**
+ * @brief Runs a BFS from (0, 0) until (W, 0) is dequeued, generating neighbors on the fly.
+ *
+ * The queue is a flat array that is never popped from the front: every state is pushed
+ * at most once, so after `reserve` it never reallocates within a query.
+ */
+bool JugSolver::Search(const StateIndex& states, int L, int S, int W, SearchStats& stats)
+{
+    uint32_t start = states.index(0, 0);
+    uint32_t goal = states.index(W, 0);
+
+    visited.Set(start);
+    queue.push_back(start);
+
+    // === BFS ===
+    for (std::size_t head = 0; head < queue.size(); head++)
+    {
+        uint32_t U = queue[head];
+        if (U == goal) // Goal state reached
+            return true;
+
+        stats.Expand();
+
+        // Neighbors are visited in lexicographic (= index) order
+        ForEachNeighbor(states, L, S, U, [&](Move move, uint32_t V)
+        {
+            stats.Relax();
+            if (!visited.Test(V)) // If not visited
+            {
+                visited.Set(V);
+                via.Set(V, move);
+                queue.push_back(V);
+            }
+        });
+        stats.Queue(queue.size() - head - 1);
+    }
+
+    return false;
+}
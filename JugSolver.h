@@ -0,0 +1,73 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include "PackedArrays.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Reusable BFS solver for the two-jug problem.
+ *
+ * Unlike Way1 and Way2, which search and print from their constructors, a JugSolver is
+ * constructed once and answers any number of queries through Solve. Its scratch buffers
+ * (visited bits, 3-bit moves, queue and path) are kept between calls and only grow when
+ * a query needs more states than any before it. The visited bits are cleared in O(1) by
+ * a generation stamp, so after warm-up a query performs no allocation and no O(n) reset.
+ *
+ * Neighbors are visited in lexicographic order, so the paths are the same ones Way1 finds.
+ * A JugSolver is not thread-safe; use one per thread.
+ *
+ * The other solvers (BitsetSolver, AStarSolver, WeightedSolver, ShortestPaths, ExternalBfs)
+ * follow the same rules: buffers kept across queries, one instance per thread, and a Result
+ * that extends JugSolver::Result with what is specific to them.
+ */
+class JugSolver
+{
+public:
+
+    /**
+     * @brief Outcome of one query.
+     *
+     * `moves` points into the solver's buffers and is valid until the next call to Solve.
+     * The solution is the one the solver optimizes for: shortest here, cheapest for WeightedSolver.
+     */
+    struct Result
+    {
+        bool solved = false;            ///< true if (W, 0) is reachable from (0, 0)
+        uint32_t operations = 0;        ///< Number of operations of the solution (0 if not solved)
+        std::span<const Move> moves;    ///< The operations of the solution, in order
+        SearchStats stats;              ///< Counters and phase times of this query (empty unless JUG_STATS is set)
+    };
+
+    /**
+     * @brief Finds a shortest sequence of operations from (0, 0) to (W, 0).
+     *
+     * @param L Capacity of the large jug
+     * @param S Capacity of the small jug, 0 <= S < L
+     * @param W Target amount in the large jug
+     * @throws std::invalid_argument if the capacities are out of range
+     */
+    Result Solve(int L, int S, int W);
+
+    /**
+     * @brief Memory currently held by the scratch buffers, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        return visited.MemoryBytes() + via.MemoryBytes()
+            + queue.capacity() * sizeof(uint32_t) + path.capacity() * sizeof(Move);
+    }
+
+private:
+    StampedBitmap visited;          ///< States reached by the current query
+    MoveArray via;                  ///< Operation that reached each visited state
+    std::vector<uint32_t> queue;    ///< BFS queue, one entry per visited state
+    std::vector<Move> path;         ///< Moves of the last solution
+
+    /**
+     * @brief BFS from (0, 0) over the pooled buffers.
+     *
+     * @return true if (W, 0) was reached
+     */
+    bool Search(const StateIndex& states, int L, int S, int W, SearchStats& stats);
+};
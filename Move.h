@@ -0,0 +1,359 @@
+#pragma once
+#include "Common.h"
+#include <iterator>
+
+/**
+ * @brief The six legal operations of the water jug problem.
+ *
+ * The order matches the order in which the operations are generated in
+ * Graph::generateAllEdges and Way2::CalculateAdjList.
+ */
+enum class Move : uint8_t
+{
+    FillLarge,          ///< Fill the large jug from the tap
+    FillSmall,          ///< Fill the small jug from the tap
+    EmptyLarge,         ///< Pour the large jug out
+    EmptySmall,         ///< Pour the small jug out
+    PourLargeToSmall,   ///< Transfer from the large jug into the small jug
+    PourSmallToLarge    ///< Transfer from the small jug into the large jug
+};
+
+/**
+ * @brief Returns the human-readable description of an operation, as printed in the solution.
+ */
+inline const char* MoveName(Move move)
+{
+    switch (move)
+    {
+    case Move::FillLarge:        return "Fill large jug";
+    case Move::FillSmall:        return "Fill small jug";
+    case Move::EmptyLarge:       return "Empty large jug";
+    case Move::EmptySmall:       return "Empty small jug";
+    case Move::PourLargeToSmall: return "Transfer from large jug to small jug";
+    case Move::PourSmallToLarge: return "Transfer from small jug to large jug";
+    }
+    return "";
+}
+
+/**
+ * @brief Returns the short code of an operation, as printed in the compact path format.
+ */
+inline const char* MoveCode(Move move)
+{
+    switch (move)
+    {
+    case Move::FillLarge:        return "FL";
+    case Move::FillSmall:        return "FS";
+    case Move::EmptyLarge:       return "EL";
+    case Move::EmptySmall:       return "ES";
+    case Move::PourLargeToSmall: return "PLS";
+    case Move::PourSmallToLarge: return "PSL";
+    }
+    return "";
+}
+
+/**
+ * @brief Number of distinct operations.
+ */
+constexpr int MoveCount = 6;
+
+/**
+ * @brief Applies one operation to a state, if it is legal.
+ *
+ * An operation is legal only if it changes the state (e.g. a full jug cannot be filled).
+ *
+ * @param move The operation
+ * @param L Capacity of the large jug
+ * @param S Capacity of the small jug
+ * @param big Amount in the large jug
+ * @param small Amount in the small jug
+ * @param toBig Receives the amount in the large jug afterwards
+ * @param toSmall Receives the amount in the small jug afterwards
+ * @return false if the operation is not legal in this state
+ */
+template <typename T>
+constexpr bool ApplyMove(Move move, T L, T S, T big, T small, T& toBig, T& toSmall)
+{
+    toBig = big;
+    toSmall = small;
+
+    switch (move)
+    {
+    case Move::FillLarge:           // 1. Fill large jug
+        toBig = L;
+        return big < L;
+
+    case Move::FillSmall:           // 2. Fill small jug
+        toSmall = S;
+        return small < S;
+
+    case Move::EmptyLarge:          // 3. Empty large jug
+        toBig = 0;
+        return big > 0;
+
+    case Move::EmptySmall:          // 4. Empty small jug
+        toSmall = 0;
+        return small > 0;
+
+    case Move::PourLargeToSmall:    // 5. Transfer from large to small
+    {
+        T pour = (big < S - small) ? big : S - small;
+        toBig = big - pour;
+        toSmall = small + pour;
+        return big > 0 && small < S;
+    }
+
+    case Move::PourSmallToLarge:    // 6. Transfer from small to large
+    {
+        T pour = (small < L - big) ? small : L - big;
+        toBig = big + pour;
+        toSmall = small - pour;
+        return small > 0 && big < L;
+    }
+    }
+    return false;
+}
+
+/**
+ * @brief Calls `emit(big, small, move)` for every reachable state that leads to (toBig, toSmall)
+ * by one legal operation.
+ *
+ * Fill, empty and transfer are not invertible on their own (filling a jug forgets how much
+ * it held), so the predecessors are derived case by case. Only states with at least one jug
+ * full or empty are reported, since no other state is reachable from (0, 0) (see StateIndex).
+ * Only the four corner states have more than a handful of predecessors.
+ */
+template <typename T, typename Emit>
+constexpr void ForEachPredecessor(T L, T S, T toBig, T toSmall, Emit emit)
+{
+    // Candidates are derived per operation below and confirmed by applying the operation forwards
+    auto emitIfLegal = [&](T big, T small, Move move)
+    {
+        T b = 0, s = 0;
+        if (ApplyMove(move, L, S, big, small, b, s) && b == toBig && s == toSmall)
+            emit(big, small, move);
+    };
+
+    const bool edgeBig = (toBig == 0 || toBig == L);        // any small amount is on the boundary
+    const bool edgeSmall = (toSmall == 0 || toSmall == S);  // any big amount is on the boundary
+
+    // 1. Fill large jug: (b, toSmall) -> (L, toSmall)
+    if (toBig == L)
+    {
+        if (edgeSmall)
+            for (T b = 0; b < L; b++) emitIfLegal(b, toSmall, Move::FillLarge);
+        else
+            emitIfLegal(T(0), toSmall, Move::FillLarge);
+    }
+
+    // 2. Fill small jug: (toBig, s) -> (toBig, S)
+    if (toSmall == S)
+    {
+        if (edgeBig)
+            for (T s = 0; s < S; s++) emitIfLegal(toBig, s, Move::FillSmall);
+        else
+            emitIfLegal(toBig, T(0), Move::FillSmall);
+    }
+
+    // 3. Empty large jug: (b, toSmall) -> (0, toSmall)
+    if (toBig == 0)
+    {
+        if (edgeSmall)
+            for (T b = 1; b <= L; b++) emitIfLegal(b, toSmall, Move::EmptyLarge);
+        else
+            emitIfLegal(L, toSmall, Move::EmptyLarge);
+    }
+
+    // 4. Empty small jug: (toBig, s) -> (toBig, 0)
+    if (toSmall == 0)
+    {
+        if (edgeBig)
+            for (T s = 1; s <= S; s++) emitIfLegal(toBig, s, Move::EmptySmall);
+        else
+            emitIfLegal(toBig, S, Move::EmptySmall);
+    }
+
+    // 5. Transfer from large to small: leaves the large jug empty or the small jug full
+    if (toBig == 0 && toSmall > 0)
+        emitIfLegal(toSmall, T(0), Move::PourLargeToSmall);
+    else if (toBig > 0 && toSmall == S && S > 0)
+    {
+        if (L - toBig <= S)
+            emitIfLegal(L, T(S - (L - toBig)), Move::PourLargeToSmall);
+        if (toBig + S < L)
+            emitIfLegal(T(toBig + S), T(0), Move::PourLargeToSmall);
+    }
+
+    // 6. Transfer from small to large: leaves the small jug empty or the large jug full
+    if (toSmall == 0 && toBig > 0)
+    {
+        if (toBig <= S)
+            emitIfLegal(T(0), toBig, Move::PourSmallToLarge);
+        if (toBig > S)
+            emitIfLegal(T(toBig - S), S, Move::PourSmallToLarge);
+    }
+    else if (toBig == L && toSmall > 0 && toSmall < S)
+        emitIfLegal(T(L - (S - toSmall)), S, Move::PourSmallToLarge);
+}
+
+/**
+ * @brief Returns the state a BFS from (0, 0) came from, given the state it reached and the
+ * operation that reached it.
+ *
+ * ForEachPredecessor may report several predecessors, but only one of them is ever the BFS
+ * parent: apart from (0, 0), reachable states have one jug full or empty, which leaves a single
+ * candidate for every operation except filling or emptying into a corner, and the corners are
+ * all reached within two operations from (0, 0). So three bits per state (the operation) are
+ * enough to rebuild a shortest path backwards.
+ *
+ * @param move The operation that reached (toBig, toSmall)
+ * @param fromBig Receives the amount in the large jug before the operation
+ * @param fromSmall Receives the amount in the small jug before the operation
+ */
+template <typename T>
+constexpr void InverseMove(Move move, T L, T S, T toBig, T toSmall, T& fromBig, T& fromSmall)
+{
+    fromBig = toBig;
+    fromSmall = toSmall;
+
+    switch (move)
+    {
+    case Move::FillLarge:  fromBig = 0; break;      // (0, s) -> (L, s)
+    case Move::FillSmall:  fromSmall = 0; break;    // (b, 0) -> (b, S)
+    case Move::EmptyLarge: fromBig = L; break;      // (L, s) -> (0, s)
+    case Move::EmptySmall: fromSmall = S; break;    // (b, S) -> (b, 0)
+
+    case Move::PourLargeToSmall:
+        if (toBig == 0)                 // the large jug was poured out completely
+        {
+            fromBig = toSmall;
+            fromSmall = 0;
+        }
+        else if (L - toBig <= S)        // the large jug was full
+        {
+            fromBig = L;
+            fromSmall = S - (L - toBig);
+        }
+        else                            // the small jug was empty
+        {
+            fromBig = toBig + S;
+            fromSmall = 0;
+        }
+        break;
+
+    case Move::PourSmallToLarge:
+        if (toSmall > 0)                // the small jug was full
+        {
+            fromBig = L - (S - toSmall);
+            fromSmall = S;
+        }
+        else if (toBig <= S)            // the large jug was empty
+        {
+            fromBig = 0;
+            fromSmall = toBig;
+        }
+        else                            // the small jug was full
+        {
+            fromBig = toBig - S;
+            fromSmall = S;
+        }
+        break;
+    }
+}
+
+/**
+ * @brief The shortest path to (W, 0), walked backwards from the operation a BFS recorded for every state.
+ *
+ * Nothing is stored: each step looks up the operation that reached the current state and undoes
+ * it with InverseMove. Iterating therefore yields the operations from the last to the first.
+ * This is the one walk every engine that records a 3-bit operation per state uses to rebuild
+ * its path, lazily (PathWriter::WriteReversed) or into a vector (RebuildPath).
+ *
+ * @tparam MoveOf Callable `Move(int big, int small)` returning the operation that reached a state
+ */
+template <typename MoveOf>
+class ParentPath
+{
+public:
+
+    /**
+     * @brief Creates the path ending at (W, 0). The BFS must have reached it.
+     */
+    ParentPath(int _L, int _S, int _W, MoveOf _moveOf) : L(_L), S(_S), W(_W), moveOf(_moveOf) {}
+
+    /**
+     * @brief Forward iterator over the operations, last operation first.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Move;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Move*;
+        using reference = Move;
+
+        iterator() = default;
+
+        Move operator*() const { return current; }
+
+        iterator& operator++()
+        {
+            InverseMove(current, path->L, path->S, big, small, big, small);
+            Load();
+            return *this;
+        }
+
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+
+        bool operator==(const iterator& other) const { return big == other.big && small == other.small; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class ParentPath;
+        iterator(const ParentPath* _path, int _big, int _small) : path(_path), big(_big), small(_small) { Load(); }
+
+        void Load()
+        {
+            if (big != 0 || small != 0)
+                current = path->moveOf(big, small);
+        }
+
+        const ParentPath* path = nullptr;
+        int big = 0, small = 0;             ///< Current state
+        Move current = Move::FillLarge;     ///< Operation that reached the current state
+    };
+
+    iterator begin() const { return iterator(this, W, 0); }
+    iterator end() const { return iterator(this, 0, 0); }
+
+    /**
+     * @brief Number of operations, found by walking the whole path once.
+     */
+    uint64_t Size() const
+    {
+        uint64_t count = 0;
+        for (auto it = begin(); it != end(); ++it)
+            count++;
+        return count;
+    }
+
+private:
+    int L, S, W;        ///< Capacities of the jugs and the target amount
+    MoveOf moveOf;      ///< Operation that reached a state
+};
+
+/**
+ * @brief Fills `path` with the operations from (0, 0) to (W, 0), first operation first.
+ *
+ * @param moveOf Callable `Move(int big, int small)` returning the operation that reached a state
+ * @param path Receives the operations; its capacity is kept from one call to the next
+ */
+template <typename MoveOf>
+void RebuildPath(int L, int S, int W, MoveOf moveOf, std::vector<Move>& path)
+{
+    path.clear();
+    for (Move move : ParentPath(L, S, W, moveOf))
+        path.push_back(move);
+    std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+
+/**
+ * @brief Fixed-size array of bits, one per state, used as a visited set.
+ */
+class Bitmap
+{
+public:
+
+    /**
+     * @brief Creates a bitmap of n cleared bits.
+     */
+    explicit Bitmap(std::size_t n = 0) : words((n + 63) / 64, 0) {}
+
+    /**
+     * @brief Returns bit i.
+     */
+    bool Test(std::size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    /**
+     * @brief Sets bit i.
+     */
+    void Set(std::size_t i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+
+    /**
+     * @brief Memory used, in bytes.
+     */
+    std::size_t MemoryBytes() const { return words.size() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> words;
+};
+
+/**
+ * @brief Bitmap that is cleared in O(1) by starting a new generation.
+ *
+ * Every 64-bit word carries the generation it was last written in. A word from an older
+ * generation reads as all zeros and is zeroed on its first write, so Reset never touches
+ * the words themselves. This costs 4 bytes per 64 bits on top of the bits.
+ */
+class StampedBitmap
+{
+public:
+
+    /**
+     * @brief Clears all bits and makes room for at least n of them.
+     *
+     * Only allocates when n is larger than any previous size.
+     */
+    void Reset(std::size_t n)
+    {
+        std::size_t count = (n + 63) / 64;
+        if (count > words.size())
+        {
+            words.resize(count, 0);
+            stamps.resize(count, 0);
+        }
+
+        if (++generation == 0)  // wrapped around: old stamps could look current again
+        {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+
+    /**
+     * @brief Returns bit i.
+     */
+    bool Test(std::size_t i) const
+    {
+        return stamps[i >> 6] == generation && ((words[i >> 6] >> (i & 63)) & 1);
+    }
+
+    /**
+     * @brief Sets bit i.
+     */
+    void Set(std::size_t i)
+    {
+        std::size_t w = i >> 6;
+        if (stamps[w] != generation)
+        {
+            stamps[w] = generation;
+            words[w] = 0;
+        }
+        words[w] |= uint64_t(1) << (i & 63);
+    }
+
+    /**
+     * @brief Memory used, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        return words.size() * sizeof(uint64_t) + stamps.size() * sizeof(uint32_t);
+    }
+
+private:
+    std::vector<uint64_t> words;    ///< The bits, valid only where the stamp is current
+    std::vector<uint32_t> stamps;   ///< Generation in which each word was last written
+    uint32_t generation = 0;        ///< Current generation
+};
+
+/**
+ * @brief Fixed-size array of Move values packed into 3 bits each.
+ *
+ * Entry i occupies bits [3i, 3i + 3) of a run of 64-bit words, and may straddle two words.
+ * Entries that were never set read as Move::FillLarge.
+ */
+class MoveArray
+{
+public:
+
+    /**
+     * @brief Creates an array of n entries.
+     */
+    explicit MoveArray(std::size_t n = 0) : words((n * 3 + 63) / 64 + 1, 0) {}
+
+    /**
+     * @brief Makes room for at least n entries, keeping the current ones.
+     *
+     * Only allocates when n is larger than any previous size.
+     */
+    void Reserve(std::size_t n)
+    {
+        std::size_t count = (n * 3 + 63) / 64 + 1;
+        if (count > words.size())
+            words.resize(count, 0);
+    }
+
+    /**
+     * @brief Returns entry i.
+     */
+    Move Get(std::size_t i) const { return Get(words.data(), i); }
+
+    /**
+     * @brief Returns entry i of a packed array stored elsewhere, e.g. in a mapped file.
+     */
+    static Move Get(const uint64_t* words, std::size_t i)
+    {
+        std::size_t bit = i * 3, w = bit >> 6, offset = bit & 63;
+        uint64_t value = words[w] >> offset;
+        if (offset > 61)
+            value |= words[w + 1] << (64 - offset);
+        return Move(value & 7);
+    }
+
+    /**
+     * @brief Stores entry i.
+     */
+    void Set(std::size_t i, Move move)
+    {
+        std::size_t bit = i * 3, w = bit >> 6, offset = bit & 63;
+        uint64_t value = uint64_t(move);
+
+        words[w] = (words[w] & ~(uint64_t(7) << offset)) | (value << offset);
+        if (offset > 61)
+        {
+            std::size_t spill = 64 - offset; // bits that fit in the first word
+            words[w + 1] = (words[w + 1] & ~(uint64_t(7) >> spill)) | (value >> spill);
+        }
+    }
+
+    /**
+     * @brief Memory used, in bytes.
+     */
+    std::size_t MemoryBytes() const { return words.size() * sizeof(uint64_t); }
+
+    /**
+     * @brief The packed words, for writing the array to a file.
+     */
+    std::span<const uint64_t> Words() const { return words; }
+
+private:
+    std::vector<uint64_t> words;
+};
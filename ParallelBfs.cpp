@@ -0,0 +1,48 @@
+#include "ParallelBfs.h"
+#include "Common.h"
+
+/**
+ * @brief Starts the pool and gives every worker its own frontier list and counters.
+ */
+ParallelBfs::ParallelBfs(unsigned threads) : pool(threads)
+{
+    local.resize(pool.WorkerCount());
+    sliceStats.resize(pool.WorkerCount());
+}
+
+/**
+ * @brief Zeroes the visited bitmap; the parents of unvisited states are never read, so they are left as they are.
+ */
+void ParallelBfs::Reset(uint32_t n)
+{
+    std::size_t words = (std::size_t(n) + 63) / 64;
+    if (visited.size() < words)
+        visited = std::vector<std::atomic<uint64_t>>(words);
+    for (std::size_t w = 0; w < words; w++)
+        visited[w].store(0, std::memory_order_relaxed);
+    if (prev.size() < n)
+        prev.resize(n);
+
+    for (std::vector<uint32_t>& list : local)
+        list.clear();
+    for (SearchStats& s : sliceStats)
+        s = SearchStats();
+    stats = SearchStats();
+    parallelLevels = 0;
+    bottomUpLevels = 0;
+}
+
+/**
+ * @brief Concatenates the per-slice frontiers. The first one is swapped in rather than copied,
+ * which is the only one used when a level runs on the calling thread.
+ */
+void ParallelBfs::GatherLocal(std::vector<uint32_t>& next)
+{
+    next.clear();
+    next.swap(local[0]);
+    for (std::size_t t = 1; t < local.size(); t++)
+    {
+        next.insert(next.end(), local[t].begin(), local[t].end());
+        local[t].clear();
+    }
+}
@@ -0,0 +1,250 @@
+#pragma once
+#include "Common.h"
+#include "SearchStats.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <bit>
+
+/**
+ * @brief Multithreaded, level-synchronous, direction-optimizing BFS over a dense numbering of states.
+ *
+ * The state space is given by callbacks: successors and predecessors of a state, both as dense
+ * indices in [0, n). Each level is split into one slice per worker of a WorkStealingPool that is
+ * started once with the engine and reused for every level and every search. Visited states are
+ * kept in a bitmap and claimed with an atomic fetch_or, so every state gets exactly one parent,
+ * and each slice collects the states it discovers in its own local frontier.
+ *
+ * The search is direction-optimizing (Beamer et al.): while the frontier is small, it expands
+ * the frontier top-down; once the frontier's edges outnumber a fraction of the unexplored
+ * edges, it switches to bottom-up steps, in which every unvisited state looks for a parent
+ * in the frontier bitmap and stops at the first one. Levels with fewer than ParallelThreshold
+ * states run on the calling thread, since handing them to the workers costs more than the level.
+ *
+ * This pays off on wide levels, such as those of Solver<N> with three or more jugs. The reachable
+ * states of two jugs form a ring whose levels hold at most four states (see AStarSolver), so a
+ * two-jug search never leaves the calling thread.
+ */
+class ParallelBfs
+{
+public:
+
+    static constexpr uint32_t None = UINT32_MAX;    ///< Returned by Search when no goal state is reachable
+
+    /**
+     * @brief Starts the workers.
+     *
+     * @param threads Number of worker threads (0 = one per hardware thread)
+     */
+    explicit ParallelBfs(unsigned threads = 0);
+
+    /**
+     * @brief Runs the BFS from `start` until a level contains a state satisfying `isGoal`.
+     *
+     * @param n Number of states; indices are in [0, n)
+     * @param start Index of the start state
+     * @param isGoal Predicate on a state index; must be safe to call from several threads
+     * @param forEachSuccessor Called as forEachSuccessor(u, emit), must call emit(v) for every successor v of u
+     * @param forEachPredecessor Called as forEachPredecessor(v, emit), must call emit(u) for every predecessor u
+     *                           of v; emit returns true once a parent is found, after which the rest may be skipped
+     * @return Index of the goal state reached, or None if no goal state is reachable
+     */
+    template <typename Goal, typename Successors, typename Predecessors>
+    uint32_t Search(uint32_t n, uint32_t start, Goal isGoal, Successors forEachSuccessor,
+                    Predecessors forEachPredecessor);
+
+    /**
+     * @brief Parent of a state reached by the last search (the start is its own parent).
+     */
+    uint32_t Parent(uint32_t v) const { return prev[v]; }
+
+    unsigned Threads() const { return pool.WorkerCount(); }     ///< Number of worker threads
+    uint64_t ParallelLevels() const { return parallelLevels; }  ///< Levels of the last search run on the workers
+    uint64_t BottomUpLevels() const { return bottomUpLevels; }  ///< Levels of the last search run bottom-up
+
+    /**
+     * @brief Counters of the last search, summed over all slices (all zero unless JUG_STATS is set).
+     */
+    const SearchStats& Stats() const { return stats; }
+
+    /**
+     * @brief Memory held by the search arrays, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        std::size_t bytes = visited.size() * sizeof(uint64_t) + prev.capacity() * sizeof(uint32_t)
+            + inFrontier.capacity() * sizeof(uint64_t);
+        for (const std::vector<uint32_t>& list : local)
+            bytes += list.capacity() * sizeof(uint32_t);
+        return bytes;
+    }
+
+private:
+    static constexpr uint64_t Alpha = 14;                   ///< Switch to bottom-up when frontier edges > unexplored edges / Alpha
+    static constexpr uint64_t Beta = 24;                    ///< Switch back to top-down when frontier size < states / Beta
+    static constexpr std::size_t ParallelThreshold = 1024;  ///< Smaller levels are expanded on the calling thread
+
+    WorkStealingPool pool;                      ///< Workers, one slice of each parallel level per worker
+    std::vector<std::atomic<uint64_t>> visited; ///< Bitmap of claimed states
+    std::vector<uint32_t> prev;                 ///< Parent of each claimed state
+    std::vector<std::vector<uint32_t>> local;   ///< Per-slice next frontiers, reused across levels
+    std::vector<uint64_t> inFrontier;           ///< Frontier bitmap for bottom-up steps
+    std::vector<SearchStats> sliceStats;        ///< Per-slice counters, merged into `stats` after the search
+    SearchStats stats;                          ///< Counters of the last search
+    uint64_t parallelLevels = 0;                ///< Levels of the last search run on the workers
+    uint64_t bottomUpLevels = 0;                ///< Levels of the last search run bottom-up
+
+    /**
+     * @brief Clears the arrays for a search over n states, allocating only if n is a new maximum.
+     */
+    void Reset(uint32_t n);
+
+    /**
+     * @brief Marks a state visited. Returns true only for the one thread that claimed it first.
+     *
+     * Most neighbors are already visited, so the bit is tested with a plain load
+     * before paying for the atomic read-modify-write.
+     */
+    bool Claim(uint32_t v)
+    {
+        uint64_t bit = uint64_t(1) << (v & 63);
+        std::atomic<uint64_t>& word = visited[v >> 6];
+        if (word.load(std::memory_order_relaxed) & bit)
+            return false;
+        return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    }
+
+    /**
+     * @brief Runs `body(begin, end, slice)` over [0, count), one slice per worker,
+     * or on the calling thread alone if count is small.
+     */
+    template <typename Body>
+    void ParallelFor(std::size_t count, std::size_t grain, Body body);
+
+    /**
+     * @brief Moves the per-slice frontiers into `next`, keeping their buffers for the next level.
+     */
+    void GatherLocal(std::vector<uint32_t>& next);
+};
+
+/**
+ * @brief Splits [0, count) into one contiguous slice per worker, each a multiple of `grain`,
+ * and waits for all of them.
+ */
+template <typename Body>
+void ParallelBfs::ParallelFor(std::size_t count, std::size_t grain, Body body)
+{
+    unsigned slices = Threads();
+    if (count < ParallelThreshold || slices == 1)
+    {
+        body(std::size_t(0), count, 0u);
+        return;
+    }
+
+    parallelLevels++;
+    std::size_t chunk = (count + slices - 1) / slices;
+    chunk = (chunk + grain - 1) / grain * grain;
+
+    for (unsigned t = 0; t < slices && t * chunk < count; t++)
+        pool.Submit([&body, t, chunk, count] { body(t * chunk, std::min(count, (t + 1) * chunk), t); });
+    pool.Wait();
+}
+
+/**
+ * @brief Level-synchronous BFS, switching between top-down and bottom-up steps.
+ */
+template <typename Goal, typename Successors, typename Predecessors>
+uint32_t ParallelBfs::Search(uint32_t n, uint32_t start, Goal isGoal, Successors forEachSuccessor,
+                             Predecessors forEachPredecessor)
+{
+    Reset(n);
+    std::vector<uint32_t> frontier = { start }, next;
+    Claim(start);
+    prev[start] = start;
+    uint64_t unexplored = n - 1;
+    bool bottomUp = false;
+
+    // Goal reached by the current level; the first slice to claim one wins
+    std::atomic<uint32_t> found{ isGoal(start) ? start : None };
+    auto visit = [&](uint32_t U, uint32_t V, unsigned t)
+    {
+        prev[V] = U;
+        local[t].push_back(V);
+        uint32_t none = None;
+        if (isGoal(V))
+            found.compare_exchange_strong(none, V, std::memory_order_relaxed);
+    };
+
+    // === One iteration per BFS level ===
+    while (!frontier.empty() && found.load(std::memory_order_relaxed) == None)
+    {
+
+        // Direction heuristic: compare the edges to check from each side
+        if (!bottomUp && frontier.size() * Alpha > unexplored)
+            bottomUp = true;
+        else if (bottomUp && frontier.size() * Beta < n)
+            bottomUp = false;
+
+        if (!bottomUp)
+        {
+            // === Top-down: every slice expands part of the frontier into its own list ===
+            ParallelFor(frontier.size(), 1, [&](std::size_t begin, std::size_t end, unsigned t)
+            {
+                for (std::size_t i = begin; i < end; i++)
+                {
+                    uint32_t U = frontier[i];
+                    sliceStats[t].Expand();
+                    forEachSuccessor(U, [&](uint32_t V)
+                    {
+                        sliceStats[t].Relax();
+                        if (Claim(V))
+                            visit(U, V, t);
+                    });
+                }
+            });
+        }
+        else
+        {
+            // === Bottom-up: every slice scans whole bitmap words for unvisited states ===
+            // Since each slice owns whole words of the visited bitmap, no two slices claim the same state.
+            bottomUpLevels++;
+            inFrontier.assign(visited.size(), 0);
+            for (uint32_t v : frontier)
+                inFrontier[v >> 6] |= uint64_t(1) << (v & 63);
+
+            ParallelFor(n, 64, [&](std::size_t begin, std::size_t end, unsigned t)
+            {
+                for (std::size_t w = begin / 64; w * 64 < end; w++)
+                {
+                    uint64_t unvisited = ~visited[w].load(std::memory_order_relaxed);
+                    while (unvisited)
+                    {
+                        uint32_t V = uint32_t(w * 64) + uint32_t(std::countr_zero(unvisited));
+                        unvisited &= unvisited - 1;
+                        if (V >= end)
+                            break;
+
+                        sliceStats[t].Expand();
+                        forEachPredecessor(V, [&](uint32_t U)
+                        {
+                            sliceStats[t].Relax();
+                            if (!(inFrontier[U >> 6] >> (U & 63) & 1))
+                                return false;
+                            Claim(V);
+                            visit(U, V, t);
+                            return true;
+                        });
+                    }
+                }
+            });
+        }
+
+        GatherLocal(next);
+        unexplored -= next.size();
+        std::swap(frontier, next);
+        stats.Queue(frontier.size());
+    }
+
+    for (const SearchStats& s : sliceStats)
+        stats.Merge(s);
+    return found.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,125 @@
+#include "PathWriter.h"
+#include <charconv>
+#include <cstring>
+
+/**
+ * @brief Parses a path format name given on the command line.
+ */
+bool PathWriter::ParseFormat(const std::string& name, PathFormat& format)
+{
+    if (name == "full") format = PathFormat::Full;
+    else if (name == "compact") format = PathFormat::Compact;
+    else if (name == "count") format = PathFormat::Count;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Binds the writer to the buffer of the calling thread.
+ */
+PathWriter::PathWriter(std::ostream& _out, PathFormat _format) : out(_out), format(_format), buffer(ThreadBuffer())
+{
+}
+
+/**
+ * @brief One buffer per thread, so its capacity is reused by every writer the thread creates.
+ */
+std::string& PathWriter::ThreadBuffer()
+{
+    thread_local std::string threadBuffer;
+    return threadBuffer;
+}
+
+/**
+ * @brief Same text as the engines printed before.
+ */
+void PathWriter::WriteNoSolution()
+{
+    buffer += "No solution.\n";
+    Flush();
+}
+
+/**
+ * @brief Appends the count line, then "Operations:" on its own line (full) or as a prefix (compact).
+ */
+void PathWriter::WriteHeader(uint64_t count)
+{
+    char digits[24];
+    buffer += "Number of operations: ";
+    buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), count).ptr);
+    buffer += '\n';
+
+    if (format == PathFormat::Full)
+        buffer += "Operations:\n";
+    else if (format == PathFormat::Compact)
+        buffer += "Operations: ";
+}
+
+/**
+ * @brief "i. Name\n" (full) or ",CODE" (compact, without the comma for the first step).
+ */
+void PathWriter::AppendStep(uint64_t i, Move move)
+{
+    if (format == PathFormat::Full)
+    {
+        char digits[24];
+        buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), i).ptr);
+        buffer += ". ";
+        buffer += MoveName(move);
+        buffer += '\n';
+    }
+    else
+    {
+        if (i > 1)
+            buffer += ',';
+        buffer += MoveCode(move);
+    }
+}
+
+/**
+ * @brief Mirror image of AppendStep: the last byte is written first.
+ */
+char* PathWriter::PutStepBackwards(char* end, uint64_t i, Move move) const
+{
+    char* p = end;
+
+    if (format == PathFormat::Full)
+    {
+        const char* name = MoveName(move);
+        std::size_t length = std::strlen(name);
+
+        *--p = '\n';
+        p -= length;
+        std::memcpy(p, name, length);
+        *--p = ' ';
+        *--p = '.';
+        do
+        {
+            *--p = char('0' + i % 10);
+            i /= 10;
+        } while (i != 0);
+    }
+    else
+    {
+        const char* code = MoveCode(move);
+        std::size_t length = std::strlen(code);
+
+        p -= length;
+        std::memcpy(p, code, length);
+        if (i > 1)
+            *--p = ',';
+    }
+    return p;
+}
+
+/**
+ * @brief Hands the buffered text to the stream in one call.
+ */
+void PathWriter::Flush()
+{
+    if (!buffer.empty())
+    {
+        out.write(buffer.data(), std::streamsize(buffer.size()));
+        buffer.clear();
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include <cstring>
+#include <ostream>
+
+/**
+ * @brief How a solution path is printed.
+ */
+enum class PathFormat
+{
+    Full,       ///< "Number of operations: n", then one numbered line per operation
+    Compact,    ///< "Number of operations: n", then the operation codes on one line ("FL,PLS,ES")
+    Count       ///< "Number of operations: n" only
+};
+
+/**
+ * @brief Formats solution paths into a large reusable buffer and writes it in big blocks.
+ *
+ * Replaces printing one operation at a time through the stream: every digit and name is copied
+ * into the buffer, which is handed to the stream only when it is full and at the end of a path.
+ * The buffer belongs to the calling thread and keeps its capacity from one path to the next.
+ *
+ * Paths are accepted in either direction. A backwards path (such as a ParentPath) is formatted
+ * from its end towards its start, so it never needs to be reversed or stored as a vector.
+ */
+class PathWriter
+{
+public:
+
+    /**
+     * @brief Parses a format name ("full", "compact" or "count").
+     *
+     * @return false if the name is not recognized
+     */
+    static bool ParseFormat(const std::string& name, PathFormat& format);
+
+    /**
+     * @brief Creates a writer for one stream and format.
+     */
+    explicit PathWriter(std::ostream& _out, PathFormat _format = PathFormat::Full);
+
+    /**
+     * @brief Writes a path given in order, first operation first.
+     *
+     * @param moves Any range of Move, traversed once
+     * @param count Number of operations in the range
+     */
+    template <typename Range>
+    void Write(Range&& moves, uint64_t count)
+    {
+        WriteHeader(count);
+        if (format != PathFormat::Count)
+        {
+            auto it = moves.begin();
+            AppendSteps(count, [&] { Move move = *it; ++it; return move; });
+        }
+        Flush();
+    }
+
+    /**
+     * @brief Writes a path given backwards, last operation first.
+     *
+     * The path is cut into blocks of BlockSteps operations. A first walk keeps an iterator at the
+     * start of every block; then the blocks are formatted from the first operation on, each one
+     * from the end of the buffer towards its start by walking from its iterator. The buffer never
+     * holds more than one block beyond BufferSize, and the iterators take one slot per block.
+     *
+     * @param moves Any forward range of Move from the last operation to the first, traversed twice
+     * @param count Number of operations in the range
+     */
+    template <typename Range>
+    void WriteReversed(const Range& moves, uint64_t count)
+    {
+        WriteHeader(count);
+        if (format == PathFormat::Count)
+        {
+            Flush();
+            return;
+        }
+
+        // === Remember where every block starts: marks[k] is at step count - k * BlockSteps ===
+        std::vector<decltype(moves.begin())> marks;
+        marks.reserve(std::size_t(count / BlockSteps + 1));
+        auto it = moves.begin();
+        for (uint64_t walked = 0; walked < count; walked++, ++it)
+        {
+            if (walked % BlockSteps == 0)
+                marks.push_back(it);
+        }
+
+        // === Fill each block backwards into the free space after the buffered text ===
+        for (std::size_t k = marks.size(); k-- > 0;)
+        {
+            uint64_t last = count - k * BlockSteps;
+            uint64_t first = last > BlockSteps ? last - BlockSteps + 1 : 1;
+
+            std::size_t start = buffer.size();
+            buffer.resize(start + std::size_t(last - first + 1) * MaxStepBytes);
+            char* end = buffer.data() + buffer.size();
+            char* p = end;
+
+            auto step = marks[k];
+            for (uint64_t i = last; i >= first; i--, ++step)
+                p = PutStepBackwards(p, i, *step);
+
+            std::memmove(buffer.data() + start, p, std::size_t(end - p));
+            buffer.resize(start + std::size_t(end - p));
+            if (buffer.size() >= BufferSize)
+                Flush();
+        }
+
+        if (format == PathFormat::Compact)
+            buffer += '\n';
+        Flush();
+    }
+
+    /**
+     * @brief Writes the line printed when there is no solution.
+     */
+    void WriteNoSolution();
+
+private:
+
+    static constexpr std::size_t BufferSize = 1 << 16;          ///< Buffered bytes that trigger a write
+    static constexpr std::size_t MaxStepBytes = 20 + 2 + 36 + 1;///< Longest step: number, ". ", name, newline
+    static constexpr uint64_t BlockSteps = BufferSize / MaxStepBytes;   ///< Steps of a backwards path formatted at once
+
+    std::ostream& out;
+    PathFormat format;
+    std::string& buffer;    ///< Buffer of the calling thread, empty between calls
+
+    /**
+     * @brief Returns the buffer of the calling thread.
+     */
+    static std::string& ThreadBuffer();
+
+    /**
+     * @brief Appends "Number of operations: n" and, if steps follow, their heading.
+     */
+    void WriteHeader(uint64_t count);
+
+    /**
+     * @brief Appends step i (1-based) in the selected format.
+     */
+    void AppendStep(uint64_t i, Move move);
+
+    /**
+     * @brief Appends `count` steps taken from `next()`, writing the buffer out whenever it fills up.
+     */
+    template <typename Next>
+    void AppendSteps(uint64_t count, Next next)
+    {
+        for (uint64_t i = 1; i <= count; i++)
+        {
+            AppendStep(i, next());
+            if (buffer.size() >= BufferSize)
+                Flush();
+        }
+        if (format == PathFormat::Compact)
+            buffer += '\n';
+    }
+
+    /**
+     * @brief Writes step i (1-based) so that it ends just before `end`.
+     *
+     * @return The first byte of the step
+     */
+    char* PutStepBackwards(char* end, uint64_t i, Move move) const;
+
+    /**
+     * @brief Writes the buffer to the stream and empties it.
+     */
+    void Flush();
+};
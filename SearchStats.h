@@ -0,0 +1,172 @@
+#pragma once
+#include "Common.h"
+
+/**
+ * @brief Set JUG_STATS to 1 (e.g. /DJUG_STATS=1) to collect SearchStats in every engine.
+ *
+ * When it is 0, SearchStats is an empty class whose members do nothing, so the
+ * instrumentation compiles away entirely.
+ */
+#ifndef JUG_STATS
+#define JUG_STATS 0
+#endif
+
+/**
+ * @brief The phases an engine spends its time in.
+ */
+enum class SearchPhase : uint8_t
+{
+    Build,      ///< Building the state graph or other tables before the search
+    Search,     ///< The search loop itself
+    Path,       ///< Rebuilding the path from the recorded moves
+    Output      ///< Printing the result
+};
+
+constexpr int SearchPhaseCount = 4;
+
+template <bool Enabled>
+class BasicSearchStats;
+
+/**
+ * @brief Counters and per-phase timers collected by an engine during one query.
+ */
+template <>
+class BasicSearchStats<true>
+{
+public:
+
+    static constexpr bool Enabled = true;
+
+    /**
+     * @brief Adds the time from its construction to its destruction to one phase.
+     */
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(BasicSearchStats& _stats, SearchPhase _phase)
+            : stats(_stats), phase(_phase), start(std::chrono::steady_clock::now()) {}
+
+        ~PhaseTimer()
+        {
+            stats.AddTime(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+
+    private:
+        BasicSearchStats& stats;
+        SearchPhase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void Expand(uint64_t count = 1) { expanded += count; }     ///< States taken off the queue or frontier
+    void Relax(uint64_t count = 1) { relaxed += count; }       ///< Edges (legal operations) examined
+    void Probe(uint64_t count = 1) { probes += count; }        ///< Hash table slots inspected
+    void Queue(std::size_t length) { maxQueue = std::max<uint64_t>(maxQueue, length); }  ///< Records a queue or frontier length
+    void Allocate(std::size_t bytes) { allocated += bytes; }   ///< Bytes of search structures allocated
+
+    /**
+     * @brief Adds a measured duration to a phase.
+     */
+    void AddTime(SearchPhase phase, long long nanoseconds) { phaseNanoseconds[int(phase)] += nanoseconds; }
+
+    /**
+     * @brief Starts timing a phase until the returned timer goes out of scope.
+     */
+    [[nodiscard]] PhaseTimer Time(SearchPhase phase) { return PhaseTimer(*this, phase); }
+
+    /**
+     * @brief Adds the counters of another stats object, e.g. one collected by another thread.
+     */
+    void Merge(const BasicSearchStats& other)
+    {
+        expanded += other.expanded;
+        relaxed += other.relaxed;
+        probes += other.probes;
+        maxQueue = std::max(maxQueue, other.maxQueue);
+        allocated += other.allocated;
+        for (int i = 0; i < SearchPhaseCount; i++)
+            phaseNanoseconds[i] += other.phaseNanoseconds[i];
+    }
+
+    uint64_t Expanded() const { return expanded; }
+    uint64_t Relaxed() const { return relaxed; }
+    uint64_t Probes() const { return probes; }
+    uint64_t MaxQueue() const { return maxQueue; }
+    uint64_t Allocated() const { return allocated; }
+    long long Nanoseconds(SearchPhase phase) const { return phaseNanoseconds[int(phase)]; }
+
+    /**
+     * @brief Prints the counters and timers on one line.
+     */
+    void Print(std::ostream& out) const
+    {
+        out << "Stats: expanded " << expanded << ", relaxed " << relaxed << ", probes " << probes
+            << ", max queue " << maxQueue << ", allocated " << allocated << " bytes"
+            << ", build " << phaseNanoseconds[0] << " ns, search " << phaseNanoseconds[1]
+            << " ns, path " << phaseNanoseconds[2] << " ns, output " << phaseNanoseconds[3] << " ns\n";
+    }
+
+    /**
+     * @brief Returns the counters and timers as a JSON object.
+     */
+    std::string ToJson() const
+    {
+        return "{\"expanded\":" + std::to_string(expanded) + ",\"relaxed\":" + std::to_string(relaxed)
+            + ",\"probes\":" + std::to_string(probes) + ",\"max_queue\":" + std::to_string(maxQueue)
+            + ",\"allocated_bytes\":" + std::to_string(allocated)
+            + ",\"build_ns\":" + std::to_string(phaseNanoseconds[0])
+            + ",\"search_ns\":" + std::to_string(phaseNanoseconds[1])
+            + ",\"path_ns\":" + std::to_string(phaseNanoseconds[2])
+            + ",\"output_ns\":" + std::to_string(phaseNanoseconds[3]) + "}";
+    }
+
+private:
+    uint64_t expanded = 0;      ///< States expanded
+    uint64_t relaxed = 0;       ///< Edges examined
+    uint64_t probes = 0;        ///< Hash table slots inspected
+    uint64_t maxQueue = 0;      ///< Longest queue or frontier
+    uint64_t allocated = 0;     ///< Bytes of search structures
+    long long phaseNanoseconds[SearchPhaseCount] = {};  ///< Time per SearchPhase
+};
+
+/**
+ * @brief Disabled stats: the same interface, with every member doing nothing.
+ */
+template <>
+class BasicSearchStats<false>
+{
+public:
+
+    static constexpr bool Enabled = false;
+
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(BasicSearchStats&, SearchPhase) {}
+        ~PhaseTimer() {}    // user-provided, so an unused timer does not trigger a warning
+    };
+
+    void Expand(uint64_t = 1) {}
+    void Relax(uint64_t = 1) {}
+    void Probe(uint64_t = 1) {}
+    void Queue(std::size_t) {}
+    void Allocate(std::size_t) {}
+    void AddTime(SearchPhase, long long) {}
+    [[nodiscard]] PhaseTimer Time(SearchPhase phase) { return PhaseTimer(*this, phase); }
+    void Merge(const BasicSearchStats&) {}
+
+    uint64_t Expanded() const { return 0; }
+    uint64_t Relaxed() const { return 0; }
+    uint64_t Probes() const { return 0; }
+    uint64_t MaxQueue() const { return 0; }
+    uint64_t Allocated() const { return 0; }
+    long long Nanoseconds(SearchPhase) const { return 0; }
+
+    void Print(std::ostream&) const {}
+    std::string ToJson() const { return "{}"; }
+};
+
+/**
+ * @brief The stats type the engines use, enabled by JUG_STATS.
+ */
+using SearchStats = BasicSearchStats<JUG_STATS != 0>;
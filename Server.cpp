@@ -0,0 +1,582 @@
+#include "Server.h"
+#include "Common.h"
+#include <charconv>
+#include <string_view>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Creates the cache and starts the workers.
+ */
+Server::Server(std::size_t budgetBytes, unsigned workerCount) : cache(budgetBytes)
+{
+    if (workerCount == 0)
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < workerCount; i++)
+        workers.emplace_back(&Server::Work, this);
+}
+
+Server::~Server()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+// === Workers ===
+
+/**
+ * @brief Takes jobs one at a time; the response goes to `done` and the main thread is woken.
+ *
+ * A worker counts as busy from taking a job until it has written the eventfd, so once
+ * DropJobs has seen no busy worker, no worker touches the eventfd again.
+ */
+void Server::Work()
+{
+    bool answered = false;
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            if (answered && --busy == 0)
+                workersIdle.notify_all();
+            jobReady.wait(lock, [&] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return; // stopping
+            job = jobs.front();
+            jobs.pop_front();
+            busy++;
+        }
+        answered = true;
+
+        std::string line;
+        try
+        {
+            line = Answer(job.L, job.S, job.W, job.stats);
+        }
+        catch (...)
+        {
+            line = "error internal\n";  // an exception must not end the worker; the client still gets its one line
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            done.push_back({ job.client, job.sequence, std::move(line) });
+        }
+        doneReady.notify_one();
+
+#ifdef __linux__
+        if (wakeFd >= 0)
+        {
+            uint64_t one = 1;
+            if (write(wakeFd, &one, sizeof(one)) < 0) {}  // counter overflow is impossible; EAGAIN needs no retry
+        }
+#endif
+    }
+}
+
+/**
+ * @brief Reduces the query by gcd(L, S), then looks the answer up in the table of the reduced
+ * jugs, computing the table if it is not cached.
+ */
+std::string Server::Answer(int L, int S, int W, bool withStats)
+{
+    std::string line = std::to_string(L) + " " + std::to_string(S) + " " + std::to_string(W) + " ";
+    SearchStats stats;
+    auto finish = [&](const char* result)
+    {
+        line += result;
+        if (withStats)
+            line += " " + stats.ToJson();
+        return line + "\n";
+    };
+
+    CanonicalQuery query = CanonicalQuery::Reduce(uint64_t(L), uint64_t(S), uint64_t(W));
+    if (!query.solvable)
+        return finish("-");
+
+    uint32_t operations;
+    try
+    {
+        if (TableCache::EstimateBytes(int(query.L), int(query.S)) > cache.BudgetBytes())
+            return finish("error too-large");
+
+        bool computed;
+        TableCache::TablePtr table = cache.Get(int(query.L), int(query.S), &computed);
+        if (computed)
+            stats.Merge(table->Stats());
+
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        operations = table->MinOperations(int(query.W));
+    }
+    catch (const std::exception&)
+    {
+        return finish("error too-large");   // the table could not be allocated
+    }
+
+    if (operations == SolutionTable::Unreachable)
+        return finish("-");
+    return finish(std::to_string(operations).c_str());
+}
+
+// === Requests and responses ===
+
+/**
+ * @brief Accepts the same separators as batch mode, and the same limits as the BFS engines.
+ */
+bool Server::ParseLine(const char* begin, const char* end, int values[3], bool& stats)
+{
+    const char* p = begin;
+    for (int i = 0; i < 3; i++)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r'))
+            p++;
+
+        auto [next, error] = std::from_chars(p, end, values[i]);
+        if (error != std::errc() || values[i] < 0)
+            return false;
+        p = next;
+    }
+
+    while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r'))
+        p++;
+
+    constexpr std::string_view keyword = "stats";
+    stats = std::string_view(p, std::size_t(end - p)).starts_with(keyword);
+    if (stats)
+    {
+        p += keyword.size();
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+    }
+
+    return p == end && values[0] > values[1] && values[2] <= values[0];
+}
+
+/**
+ * @brief Invalid lines are answered right away; valid ones are queued, all under one lock.
+ */
+void Server::ParseRequests(uint64_t id, Client& client)
+{
+    std::size_t start = 0, newline;
+    bool queued = false;
+
+    if (client.skipLine)
+    {
+        if ((newline = client.in.find('\n')) == std::string::npos)
+        {
+            client.in.clear();
+            return;
+        }
+        start = newline + 1;
+        client.skipLine = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        while ((newline = client.in.find('\n', start)) != std::string::npos)
+        {
+            const char* line = client.in.data() + start;
+            std::size_t length = newline - start;
+            start = newline + 1;
+
+            if (length == 0 || (length == 1 && line[0] == '\r'))
+                continue;   // blank lines are not requests
+
+            int values[3];
+            bool stats;
+            uint64_t sequence = client.nextSequence++;
+            if (ParseLine(line, line + length, values, stats))
+            {
+                jobs.push_back({ id, sequence, values[0], values[1], values[2], stats });
+                queued = true;
+            }
+            else
+                Deliver(client, sequence, "error invalid-request\n");
+        }
+    }
+
+    client.in.erase(0, start);
+    if (client.in.size() > MaxLineBytes)
+    {
+        Deliver(client, client.nextSequence++, "error invalid-request\n");
+        client.in.clear();
+        client.skipLine = true;
+    }
+
+    if (queued)
+        jobReady.notify_all();
+}
+
+/**
+ * @brief Unanswered requests and unsent responses of the client, then the shared job queue.
+ */
+bool Server::Backlogged(const Client& client)
+{
+    if (client.nextSequence - client.nextToSend >= MaxPending || client.out.size() >= MaxOutputBytes)
+        return true;
+
+    std::lock_guard<std::mutex> lock(jobMutex);
+    return jobs.size() >= MaxQueuedJobs;
+}
+
+/**
+ * @brief The responses of the dropped jobs would go to clients that are being closed anyway.
+ */
+void Server::DropJobs()
+{
+    {
+        std::unique_lock<std::mutex> lock(jobMutex);
+        jobs.clear();
+        workersIdle.wait(lock, [&] { return busy == 0; });
+    }
+
+    std::lock_guard<std::mutex> lock(doneMutex);
+    done.clear();
+}
+
+/**
+ * @brief Appends the run of consecutive responses starting at nextToSend.
+ */
+void Server::Deliver(Client& client, uint64_t sequence, std::string line)
+{
+    if (sequence != client.nextToSend)
+    {
+        client.ready.emplace(sequence, std::move(line));
+        return;
+    }
+
+    client.out += line;
+    client.nextToSend++;
+
+    for (auto it = client.ready.begin(); it != client.ready.end() && it->first == client.nextToSend;
+        it = client.ready.erase(it))
+    {
+        client.out += it->second;
+        client.nextToSend++;
+    }
+}
+
+/**
+ * @brief Swaps the shared list out under the lock, then delivers without holding it.
+ */
+template <typename Lookup>
+void Server::CollectDone(Lookup lookup)
+{
+    std::vector<Done> batch;
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        batch.swap(done);
+    }
+
+    for (Done& response : batch)
+    {
+        if (Client* client = lookup(response.client))
+            Deliver(*client, response.sequence, std::move(response.line));
+    }
+}
+
+// === Stdio mode ===
+
+/**
+ * @brief Reads in large chunks, writes whatever is in order after each chunk, and waits
+ * for the remaining responses at end of input.
+ *
+ * Reading stops while the client is backlogged, so the input is never read further ahead
+ * of the workers than MaxPending requests.
+ */
+int Server::RunStdio(FILE* in, FILE* out)
+{
+    Client client;
+    std::vector<char> buffer(ReadSize);
+    auto lookup = [&](uint64_t) { return &client; };
+
+    // Delivers the finished responses, first waiting for one if asked to
+    auto collect = [&](bool wait)
+    {
+        if (wait)
+        {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneReady.wait(lock, [&] { return !done.empty(); });
+        }
+        CollectDone(lookup);
+
+        if (client.out.size() >= WriteSize)
+        {
+            fwrite(client.out.data(), 1, client.out.size(), out);
+            client.out.clear();
+        }
+    };
+
+    std::size_t count;
+    while ((count = fread(buffer.data(), 1, buffer.size(), in)) > 0)
+    {
+        client.in.append(buffer.data(), count);
+        ParseRequests(0, client);
+        collect(false);
+        while (Backlogged(client))
+            collect(true);
+    }
+
+    if (!client.in.empty())
+    {
+        client.in += '\n';  // last line without a newline
+        ParseRequests(0, client);
+    }
+
+    // === Wait for the workers to answer everything ===
+    while (client.nextToSend < client.nextSequence)
+        collect(true);
+
+    fwrite(client.out.data(), 1, client.out.size(), out);
+    fflush(out);
+    return 0;
+}
+
+// === Socket mode ===
+
+#ifdef __linux__
+
+namespace
+{
+    volatile std::sig_atomic_t stopRequested = 0;  ///< Set by SIGINT / SIGTERM
+
+    void RequestStop(int) { stopRequested = 1; }
+
+    constexpr uint64_t ListenTag = 0;   ///< epoll data of the listening socket
+    constexpr uint64_t WakeTag = 1;     ///< epoll data of the eventfd; clients start at 2
+}
+
+/**
+ * @brief Event loop: one epoll set holds the listening socket, the eventfd and every client.
+ *
+ * Clients are registered by id rather than by fd, so a response for a client that has
+ * disconnected (and whose fd may have been reused) is simply dropped. A backlogged client is
+ * paused by leaving EPOLLIN out of its events, and is checked again on every iteration.
+ */
+int Server::RunSocket(const std::string& path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path too long." << std::endl;
+        return 1;
+    }
+    path.copy(address.sun_path, path.size());
+
+    // === Set up the socket, the eventfd and the epoll set ===
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(path.c_str());
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || listen(listenFd, SOMAXCONN) < 0)
+    {
+        std::cerr << "Cannot listen on " << path << "." << std::endl;
+        if (listenFd >= 0)
+            close(listenFd);
+        return 1;
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = ListenTag;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.u64 = WakeTag;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    struct sigaction action = {};
+    action.sa_handler = RequestStop;    // no SA_RESTART: epoll_wait returns EINTR
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::map<uint64_t, Client> clients;
+    uint64_t nextId = WakeTag + 1;
+    std::vector<char> buffer(ReadSize);
+    std::vector<uint64_t> touched;      // clients with new output in this iteration
+    std::set<uint64_t> paused;          // clients not read until their backlog shrinks
+
+    auto lookup = [&](uint64_t id) -> Client*
+    {
+        auto it = clients.find(id);
+        if (it == clients.end())
+            return nullptr;
+        touched.push_back(id);
+        return &it->second;
+    };
+
+    // Sends as much of the output as the socket takes; asks for EPOLLOUT if some is left
+    auto flush = [&](uint64_t id, Client& client) -> bool
+    {
+        std::size_t sent = 0;
+        while (sent < client.out.size())
+        {
+            ssize_t n = send(client.fd, client.out.data() + sent, client.out.size() - sent, MSG_NOSIGNAL);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    return false;
+                break;
+            }
+            sent += std::size_t(n);
+        }
+        client.out.erase(0, sent);
+
+        // Once the client has closed its side, or while it is backlogged, only writability is of interest
+        bool backlogged = !client.readClosed && Backlogged(client);
+        if (backlogged)
+            paused.insert(id);
+        else
+            paused.erase(id);
+
+        epoll_event update = {};
+        update.events = (client.readClosed || backlogged ? 0u : uint32_t(EPOLLIN | EPOLLRDHUP))
+            | (client.out.empty() ? 0u : uint32_t(EPOLLOUT));
+        update.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &update);
+
+        // A client that has closed its side is done once every response is sent
+        return !(client.readClosed && client.out.empty() && client.nextToSend == client.nextSequence);
+    };
+
+    auto drop = [&](uint64_t id)
+    {
+        auto it = clients.find(id);
+        if (it == clients.end())
+            return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        close(it->second.fd);
+        clients.erase(it);
+        paused.erase(id);
+    };
+
+    // === Event loop ===
+    epoll_event events[64];
+    while (!stopRequested)
+    {
+        int count = epoll_wait(epollFd, events, 64, -1);
+        if (count < 0)
+            continue;   // EINTR: check stopRequested
+
+        touched.clear();
+
+        for (int i = 0; i < count; i++)
+        {
+            uint64_t tag = events[i].data.u64;
+
+            if (tag == ListenTag)
+            {
+                int fd;
+                while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                {
+                    uint64_t id = nextId++;
+                    clients[id].fd = fd;
+
+                    epoll_event add = {};
+                    add.events = EPOLLIN | EPOLLRDHUP;
+                    add.data.u64 = id;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &add);
+                }
+            }
+            else if (tag == WakeTag)
+            {
+                uint64_t value;
+                while (read(wakeFd, &value, sizeof(value)) > 0) {}
+                CollectDone(lookup);
+            }
+            else
+            {
+                auto it = clients.find(tag);
+                if (it == clients.end())
+                    continue;
+                Client& client = it->second;
+
+                if (events[i].events & (EPOLLERR | EPOLLHUP))
+                {
+                    drop(tag);  // gone in both directions: its responses cannot be delivered
+                    continue;
+                }
+
+                if (!client.readClosed && (events[i].events & (EPOLLIN | EPOLLRDHUP)))
+                {
+                    while (!Backlogged(client))
+                    {
+                        ssize_t n = read(client.fd, buffer.data(), buffer.size());
+                        if (n > 0)
+                        {
+                            client.in.append(buffer.data(), std::size_t(n));
+                            ParseRequests(tag, client);
+                        }
+                        else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                        {
+                            client.readClosed = true;
+                            break;
+                        }
+                        else if (errno != EINTR)
+                            break;
+                    }
+
+                    if (client.readClosed && !client.in.empty())
+                    {
+                        client.in += '\n';  // last line without a newline
+                        ParseRequests(tag, client);
+                    }
+                }
+                touched.push_back(tag);
+            }
+        }
+
+        // === One batched write per client with new output; paused clients may resume ===
+        touched.insert(touched.end(), paused.begin(), paused.end());
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (uint64_t id : touched)
+        {
+            auto it = clients.find(id);
+            if (it != clients.end() && !flush(id, it->second))
+                drop(id);
+        }
+    }
+
+    // === Shutdown: no worker may write the eventfd once it is closed ===
+    DropJobs();
+    for (auto& [id, client] : clients)
+        close(client.fd);
+    close(listenFd);
+    close(epollFd);
+    close(wakeFd);
+    wakeFd = -1;
+    unlink(path.c_str());
+    return 0;
+}
+
+#else
+
+int Server::RunSocket(const std::string&)
+{
+    std::cerr << "Socket mode is only available on Linux; use stdio mode." << std::endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,191 @@
+#pragma once
+#include "Common.h"
+#include "TableCache.h"
+#include "CanonicalQuery.h"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+/**
+ * @brief Long-running solver: answers pipelined "L S W" requests from a Unix socket or stdin.
+ *
+ * Protocol: one request per line, "L S W" (spaces, tabs or commas between the numbers).
+ * Each request gets exactly one response line, in request order per client:
+ * - "L S W operations" when (W, 0) is reachable,
+ * - "L S W -" when it is not,
+ * - "L S W error too-large" when the table for (L, S) would not fit the memory budget or
+ *   has more states than StateIndex can number,
+ * - "error invalid-request" when the line is not a valid query,
+ * - "error internal" if answering failed in any other way.
+ * A request may end with the word "stats" to have its response followed by a space and a
+ * SearchStats JSON object (see SearchStats::ToJson; "{}" unless JUG_STATS is set): the lookup
+ * as the search phase and, if this request computed its table, the table's BFS.
+ *
+ * Requests are solved by a pool of worker threads from SolutionTables kept in a TableCache
+ * (an LRU bounded by a memory budget), so a client that repeats a jug pair pays for one BFS.
+ * Each request is reduced by gcd(L, S) first (see CanonicalQuery), so scaled copies of a pair
+ * share its table and a target that is not a multiple is answered without one.
+ * Completed responses go through a per-client reorder buffer and are written in batches:
+ * everything that is ready is appended to one buffer and sent with a single write.
+ *
+ * In socket mode an epoll event loop on the main thread accepts clients, reads requests and
+ * writes responses without blocking; workers wake it through an eventfd. Socket mode is
+ * available on Linux only; stdio mode works everywhere and is meant for testing.
+ *
+ * Memory per client is bounded: a client is not read while it has MaxPending unanswered
+ * requests or MaxOutputBytes of unsent responses, and no client is read while MaxQueuedJobs
+ * jobs wait for a worker; the kernel's socket buffer then pushes back on the sender. A line
+ * longer than MaxLineBytes is answered as an invalid request without being kept.
+ */
+class Server
+{
+public:
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param budgetBytes Memory budget of the table cache, in bytes
+     * @param workerCount Number of worker threads (0 = one per hardware thread)
+     */
+    Server(std::size_t budgetBytes, unsigned workerCount = 0);
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~Server();
+
+    /**
+     * @brief Answers the requests read from `in` on `out` until end of input.
+     *
+     * @return 0 on success
+     */
+    int RunStdio(FILE* in, FILE* out);
+
+    /**
+     * @brief Listens on a Unix domain socket and serves clients until SIGINT or SIGTERM.
+     *
+     * @param path Filesystem path of the socket (replaced if it exists)
+     * @return 0 after a clean shutdown, 1 if the socket cannot be set up
+     */
+    int RunSocket(const std::string& path);
+
+private:
+
+    /**
+     * @brief One request waiting for a worker.
+     */
+    struct Job
+    {
+        uint64_t client;    ///< Client the request came from
+        uint64_t sequence;  ///< Position of the request in that client's stream
+        int L, S, W;        ///< Query
+        bool stats;         ///< Append the SearchStats of the answer to the response
+    };
+
+    /**
+     * @brief One response produced by a worker.
+     */
+    struct Done
+    {
+        uint64_t client;
+        uint64_t sequence;
+        std::string line;   ///< Response line, with its newline
+    };
+
+    /**
+     * @brief State of one client stream.
+     */
+    struct Client
+    {
+        int fd = -1;                            ///< Socket, or -1 in stdio mode
+        std::string in;                         ///< Bytes received but not yet parsed (a partial line)
+        std::string out;                        ///< Responses ready to send, in order
+        uint64_t nextSequence = 0;              ///< Sequence number of the next request
+        uint64_t nextToSend = 0;                ///< Sequence number of the next response to append to `out`
+        std::map<uint64_t, std::string> ready;  ///< Reorder buffer: responses that arrived early
+        bool readClosed = false;                ///< The client will send no more requests
+        bool skipLine = false;                  ///< Discarding the rest of an overlong line
+    };
+
+    static constexpr std::size_t ReadSize = 64 * 1024;  ///< Bytes read per call
+    static constexpr std::size_t WriteSize = 64 * 1024; ///< Stdio output is flushed beyond this size
+    static constexpr std::size_t MaxLineBytes = 4096;   ///< Longer request lines are answered as invalid
+    static constexpr uint64_t MaxPending = 16384;       ///< A client is not read with this many unanswered requests
+    static constexpr std::size_t MaxOutputBytes = 1 << 20;  ///< ...or this many bytes of responses not yet sent
+    static constexpr std::size_t MaxQueuedJobs = 65536; ///< No client is read while this many jobs are queued
+
+    TableCache cache;                       ///< Solved tables, shared by all workers
+    std::vector<std::thread> workers;       ///< Worker pool
+
+    std::mutex jobMutex;                    ///< Guards jobs, busy and stopping
+    std::condition_variable jobReady;       ///< Signaled when a job is queued or on shutdown
+    std::condition_variable workersIdle;    ///< Signaled when the last busy worker finishes its job
+    std::deque<Job> jobs;                   ///< Requests waiting for a worker
+    unsigned busy = 0;                      ///< Workers between taking a job and waking the main thread
+    bool stopping = false;                  ///< Workers exit when set
+
+    std::mutex doneMutex;                   ///< Guards done
+    std::condition_variable doneReady;      ///< Signaled when a response is produced (stdio mode)
+    std::vector<Done> done;                 ///< Responses not yet picked up by the main thread
+    std::atomic<int> wakeFd{ -1 };          ///< eventfd written when a response is produced (socket mode)
+
+    /**
+     * @brief Worker thread: takes jobs until shutdown and answers them.
+     */
+    void Work();
+
+    /**
+     * @brief Solves one query and formats its response line.
+     *
+     * @param withStats Append the SearchStats of the answer as a JSON object
+     */
+    std::string Answer(int L, int S, int W, bool withStats);
+
+    /**
+     * @brief Parses the complete lines in `client.in`, queueing a job for each valid request.
+     *
+     * An incomplete line longer than MaxLineBytes is answered as invalid and its remaining
+     * bytes are skipped up to the next newline.
+     */
+    void ParseRequests(uint64_t id, Client& client);
+
+    /**
+     * @brief Returns true if no more requests should be read from this client for now.
+     */
+    bool Backlogged(const Client& client);
+
+    /**
+     * @brief Drops the queued jobs and waits until no worker is running one (socket shutdown).
+     */
+    void DropJobs();
+
+    /**
+     * @brief Parses one request line.
+     *
+     * @param stats Set to true if the line ends with "stats"
+     * @return false if it does not hold exactly three non-negative integers forming a valid query,
+     *         optionally followed by "stats"
+     */
+    static bool ParseLine(const char* begin, const char* end, int values[3], bool& stats);
+
+    /**
+     * @brief Stores a response in the client's reorder buffer and moves every response that
+     * is now in order to its output buffer.
+     */
+    static void Deliver(Client& client, uint64_t sequence, std::string line);
+
+    /**
+     * @brief Moves the worker responses to their clients.
+     *
+     * @param clients Lookup from client id to client (ids without a client are dropped)
+     */
+    template <typename Lookup>
+    void CollectDone(Lookup lookup);
+};
@@ -0,0 +1,208 @@
+#include "ShortestPaths.h"
+#include "Common.h"
+
+/**
+ * @brief Prepares the pooled buffers, runs the search, then builds and counts the sub-DAG.
+ */
+ShortestPaths::Result ShortestPaths::Solve(int _L, int _S, int W)
+{
+    if (_S < 0 || _L <= _S)
+        throw std::invalid_argument("ShortestPaths: capacities must satisfy 0 <= S < L");
+
+    L = _L;
+    S = _S;
+    states = StateIndex(L, S);
+    solved = false;
+    operations = 0;
+
+    Result result;
+    if (W < 0 || W > L)
+        return result;
+
+    SearchStats& stats = result.stats;
+    uint32_t n = states.size();
+    uint32_t goal = states.index(W, 0);
+
+    // === Prepare the pooled buffers (no allocation unless n is a new maximum) ===
+    {
+        auto buildTimer = stats.Time(SearchPhase::Build);
+        std::size_t before = MemoryBytes();
+        visited.Reset(n);
+        dag.Reset(n);
+        if (dist.size() < n)
+            dist.resize(n);
+        queue.clear();
+        queue.reserve(n);
+        stats.Allocate(MemoryBytes() - before);
+    }
+
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        solved = Search(goal, stats);
+    }
+    if (!solved)
+        return result;
+
+    {
+        auto pathTimer = stats.Time(SearchPhase::Path);
+        CountPaths(goal, result);
+    }
+
+    operations = dist[goal];
+    result.solved = true;
+    result.operations = operations;
+    return result;
+}
+
+/**
+ * @brief Plain BFS with a flat queue, as in JugSolver, but recording distances instead of moves.
+ *
+ * When the goal is dequeued every state of the levels before it has been expanded, so every
+ * state up to the goal's level has its final distance.
+ */
+bool ShortestPaths::Search(uint32_t goal, SearchStats& stats)
+{
+    uint32_t start = states.index(0, 0);
+    visited.Set(start);
+    dist[start] = 0;
+    queue.push_back(start);
+
+    for (std::size_t head = 0; head < queue.size(); head++)
+    {
+        uint32_t U = queue[head];
+        if (U == goal)
+            return true;
+
+        auto [big, small] = states.state(U);
+        stats.Expand();
+
+        int toBig, toSmall;
+        for (int m = 0; m < MoveCount; m++)
+        {
+            if (!ApplyMove(Move(m), L, S, big, small, toBig, toSmall))
+                continue;
+
+            stats.Relax();
+            uint32_t V = states.index(toBig, toSmall);
+            if (!visited.Test(V))
+            {
+                visited.Set(V);
+                dist[V] = dist[U] + 1;
+                queue.push_back(V);
+            }
+        }
+        stats.Queue(queue.size() - head - 1);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Backward sweep from the goal: the predecessors of one level that are one step closer
+ * to (0, 0) form the next level, and each level's counts are added to its predecessors'.
+ *
+ * All the successors of a level's states within the sub-DAG lie in the level swept before it,
+ * so their counts are complete by the time they are added to the predecessors.
+ */
+void ShortestPaths::CountPaths(uint32_t goal, Result& result)
+{
+    Layer* current = &layers[0];
+    Layer* next = &layers[1];
+    current->states.assign(1, goal);
+    current->counts.assign(1, 1);
+    dag.Set(goal);
+    result.dagStates = 1;
+
+    for (uint32_t level = dist[goal]; level > 0; level--)
+    {
+        next->states.clear();
+        next->counts.clear();
+        slots.Clear();
+
+        for (std::size_t i = 0; i < current->states.size(); i++)
+        {
+            auto [toBig, toSmall] = states.state(current->states[i]);
+            ForEachPredecessor(L, S, toBig, toSmall, [&](int big, int small, Move)
+            {
+                uint32_t U = states.index(big, small);
+                if (!visited.Test(U) || dist[U] != level - 1)
+                    return;
+
+                if (slots.InsertIfAbsent(U, next->states.size()))
+                {
+                    dag.Set(U);
+                    next->states.push_back(U);
+                    next->counts.emplace_back();
+                }
+                next->counts[*slots.Find(U)] += current->counts[i];
+                result.dagEdges++;
+            });
+        }
+
+        std::swap(current, next);
+        result.dagStates += current->states.size();
+    }
+
+    result.count = current->counts[0];  // the last level is (0, 0) alone
+}
+
+/**
+ * @brief Starts before the first sequence; an unsolved query has none.
+ */
+ShortestPaths::Enumerator::Enumerator(const ShortestPaths& _owner, bool solved, uint32_t operations)
+    : owner(_owner), trail(operations + 1, { 0, 0 }), moves(operations), done(!solved)
+{
+}
+
+/**
+ * @brief Depth-first walk of the sub-DAG from (0, 0), trying operations in Move order.
+ *
+ * The next sequence after the current one changes its last operation that has a later
+ * alternative, then completes the sequence with the first alternatives from there on.
+ */
+bool ShortestPaths::Enumerator::Next()
+{
+    if (done)
+        return false;
+
+    std::size_t from = 0;
+    if (started)
+    {
+        // === Backtrack to the last step that has another way into the sub-DAG ===
+        std::size_t i = moves.size();
+        while (i > 0 && !Advance(i - 1, int(moves[i - 1]) + 1))
+            i--;
+        if (i == 0)
+        {
+            done = true;
+            return false;
+        }
+        from = i;
+    }
+    started = true;
+
+    // === Complete the sequence with the first operation at every step ===
+    for (std::size_t i = from; i < moves.size(); i++)
+        Advance(i, 0);  // never fails: every state of the sub-DAG reaches the goal
+    return true;
+}
+
+/**
+ * @brief Tries operations `first` to 5 from trail[i] and keeps the first that reaches the next level of the sub-DAG.
+ */
+bool ShortestPaths::Enumerator::Advance(std::size_t i, int first)
+{
+    auto [big, small] = trail[i];
+    int toBig, toSmall;
+    for (int m = first; m < MoveCount; m++)
+    {
+        if (ApplyMove(Move(m), owner.L, owner.S, big, small, toBig, toSmall)
+            && owner.OnDag(owner.states.index(toBig, toSmall), uint32_t(i + 1)))
+        {
+            moves[i] = Move(m);
+            trail[i + 1] = { toBig, toSmall };
+            return true;
+        }
+    }
+    return false;
+}
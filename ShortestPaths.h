@@ -0,0 +1,159 @@
+#pragma once
+#include "Common.h"
+#include "JugSolver.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include "PackedArrays.h"
+#include "FlatHashMap.h"
+#include "BigCount.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Counts and lists all shortest solutions of a two-jug query, not just one.
+ *
+ * Way1 and JugSolver keep the first parent they find for each state, so they return one
+ * shortest sequence out of possibly several. Solve instead runs the BFS from (0, 0) up to the
+ * level of (W, 0) and keeps every state's distance. The edges u -> v with dist(v) = dist(u) + 1
+ * form a layered DAG that contains every shortest sequence; its part that leads to (W, 0) is
+ * found by walking back from the goal with ForEachPredecessor, one level at a time. The same
+ * walk is the dynamic program that counts the paths: when a level is reached, the count of each
+ * of its states (its number of paths to the goal) is final and is added to its predecessors.
+ *
+ * The sub-DAG is recorded as one bit per state on top of the distances; its edges are not
+ * stored but regenerated with ApplyMove when needed. Counts are only kept for the level being
+ * swept and the next one, as BigCount values, so they cannot overflow. No two operations lead
+ * from one state to the same state, so a path of the DAG is exactly one sequence of operations.
+ *
+ * Enumerate returns a generator that yields the sequences one by one in lexicographic order of
+ * their operations (in Move order), holding only the current sequence. Every state of the
+ * sub-DAG leads to the goal, so it never backtracks out of a dead end: each sequence costs at
+ * most 6 operations tried per step.
+ */
+class ShortestPaths
+{
+public:
+
+    /**
+     * @brief Outcome of one query. `moves` is left empty: Enumerate lists the sequences.
+     */
+    struct Result : JugSolver::Result
+    {
+        BigCount count;                 ///< Number of distinct shortest sequences (0 if not solved)
+        std::size_t dagStates = 0;      ///< States that lie on some shortest sequence
+        std::size_t dagEdges = 0;       ///< Operations between them that some shortest sequence uses
+    };
+
+    /**
+     * @brief Lazy generator of the shortest sequences of the last query, in lexicographic order.
+     *
+     * Valid until the next call to Solve.
+     */
+    class Enumerator
+    {
+    public:
+
+        /**
+         * @brief Advances to the next sequence.
+         *
+         * @return false once every sequence has been produced (or if the query had no solution)
+         */
+        bool Next();
+
+        /**
+         * @brief The operations of the current sequence, in order. Valid until the next call to Next.
+         */
+        std::span<const Move> Moves() const { return moves; }
+
+    private:
+        friend class ShortestPaths;
+
+        Enumerator(const ShortestPaths& owner, bool solved, uint32_t operations);
+
+        const ShortestPaths& owner;                 ///< Solver whose sub-DAG is walked
+        std::vector<std::pair<int, int>> trail;     ///< trail[i] is the state after i operations
+        std::vector<Move> moves;                    ///< moves[i] leads from trail[i] to trail[i + 1]
+        bool started = false;                       ///< true once the first sequence was produced
+        bool done;                                  ///< true once there is nothing left to produce
+
+        /**
+         * @brief Sets moves[i] to the first operation from `first` on that stays in the sub-DAG.
+         *
+         * @return false if there is none
+         */
+        bool Advance(std::size_t i, int first);
+    };
+
+    /**
+     * @brief Builds the shortest-path DAG from (0, 0) to (W, 0) and counts its paths.
+     *
+     * @param L Capacity of the large jug
+     * @param S Capacity of the small jug, 0 <= S < L
+     * @param W Target amount in the large jug
+     * @throws std::invalid_argument if the capacities are out of range
+     */
+    Result Solve(int L, int S, int W);
+
+    /**
+     * @brief Returns a generator over the shortest sequences of the last query.
+     */
+    Enumerator Enumerate() const { return Enumerator(*this, solved, operations); }
+
+    /**
+     * @brief Memory currently held by the buffers, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        std::size_t bytes = visited.MemoryBytes() + dist.capacity() * sizeof(uint32_t)
+            + queue.capacity() * sizeof(uint32_t) + dag.MemoryBytes() + slots.MemoryBytes();
+        for (const Layer& layer : layers)
+        {
+            bytes += layer.states.capacity() * sizeof(uint32_t) + layer.counts.capacity() * sizeof(BigCount);
+            for (const BigCount& count : layer.counts)
+                bytes += count.MemoryBytes();
+        }
+        return bytes;
+    }
+
+private:
+
+    /**
+     * @brief States of one level of the sub-DAG, with their numbers of paths to the goal.
+     */
+    struct Layer
+    {
+        std::vector<uint32_t> states;   ///< The states, in the order they were found
+        std::vector<BigCount> counts;   ///< Paths from states[i] to the goal
+    };
+
+    StampedBitmap visited;          ///< States reached by the current query
+    std::vector<uint32_t> dist;     ///< Distance from (0, 0), valid where `visited` is set
+    std::vector<uint32_t> queue;    ///< BFS queue, one entry per visited state
+    StampedBitmap dag;              ///< States of the sub-DAG
+    Layer layers[2];                ///< The level being swept and the one before it
+    FlatHashMap slots;              ///< States of the level before, mapped to their position in it
+
+    StateIndex states{ 1, 0 };      ///< Numbering of the last query's states
+    int L = 1, S = 0;               ///< Capacities of the last query
+    bool solved = false;            ///< Outcome of the last query
+    uint32_t operations = 0;        ///< Length of the last query's shortest sequences
+
+    /**
+     * @brief BFS from (0, 0) until (W, 0) is dequeued, recording every visited state's distance.
+     *
+     * @return true if (W, 0) was reached
+     */
+    bool Search(uint32_t goal, SearchStats& stats);
+
+    /**
+     * @brief Walks back from the goal level by level, collecting the sub-DAG and counting its paths.
+     */
+    void CountPaths(uint32_t goal, Result& result);
+
+    /**
+     * @brief Returns true if state v is on the sub-DAG, at distance `level` from (0, 0).
+     */
+    bool OnDag(uint32_t v, uint32_t level) const
+    {
+        return dag.Test(v) && dist[v] == level;
+    }
+};
@@ -0,0 +1,225 @@
+#include "SolutionCache.h"
+#include "PackedArrays.h"
+#include "Common.h"
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Maps the file for (L, S), computing and writing the table when the file is unusable.
+ *
+ * If another process replaces the file between our write and our map, we map its copy,
+ * which holds the same table.
+ */
+SolutionCache::SolutionCache(const std::string& directory, int _L, int _S)
+    : L(_L), S(_S), states(_L, _S)
+{
+    std::string path = FileName(directory, L, S);
+    if (Map(path))
+        return;
+
+    Write(SolutionTable(L, S), path);
+    built = true;
+
+    if (!Map(path))
+        throw std::runtime_error("SolutionCache: cannot map " + path);
+}
+
+SolutionCache::~SolutionCache()
+{
+    Unmap();
+}
+
+/**
+ * @brief One file per (L, S); the version lives in the header, so an old file is simply rebuilt.
+ */
+std::string SolutionCache::FileName(const std::string& directory, int L, int S)
+{
+    return directory + "/table-" + std::to_string(L) + "-" + std::to_string(S) + ".bin";
+}
+
+/**
+ * @brief Writes header, distances and moves to a file named after this process and call,
+ * flushes it to disk, and renames it over `path`.
+ */
+void SolutionCache::Write(const SolutionTable& table, const std::string& path)
+{
+    static std::atomic<uint64_t> sequence{ 0 };    // tells apart concurrent writers in one process
+
+    std::span<const uint32_t> distances = table.Distances();
+    std::span<const uint64_t> words = table.Moves().Words();
+
+    Header header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrderMark;
+    header.L = table.GetL();
+    header.S = table.GetS();
+    header.stateCount = uint32_t(distances.size());
+    header.distOffset = sizeof(Header);
+    header.movesOffset = (header.distOffset + distances.size_bytes() + 7) / 8 * 8;   // 8-byte aligned
+    header.movesWords = words.size();
+    header.fileSize = header.movesOffset + words.size_bytes();
+
+#ifdef _WIN32
+    std::string temp = path + ".tmp." + std::to_string(_getpid());
+#else
+    std::string temp = path + ".tmp." + std::to_string(getpid());
+#endif
+    temp += "." + std::to_string(sequence++);
+
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file)
+        throw std::runtime_error("SolutionCache: cannot create " + temp);
+
+    static const char padding[8] = {};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(distances.data(), 1, distances.size_bytes(), file) == distances.size_bytes()
+        && fwrite(padding, 1, header.movesOffset - header.distOffset - distances.size_bytes(), file)
+            == header.movesOffset - header.distOffset - distances.size_bytes()
+        && fwrite(words.data(), 1, words.size_bytes(), file) == words.size_bytes()
+        && fflush(file) == 0;
+
+    // The data must be on disk before the rename makes it visible under the final name
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = (fclose(file) == 0) && ok;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    ok = ok && rename(temp.c_str(), path.c_str()) == 0;
+#endif
+
+    if (!ok)
+    {
+        remove(temp.c_str());
+        throw std::runtime_error("SolutionCache: cannot write " + path);
+    }
+}
+
+/**
+ * @brief Maps the whole file read-only and validates the header before exposing the arrays.
+ */
+bool SolutionCache::Map(const std::string& path)
+{
+    // === Map the file ===
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER length;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &length) && length.QuadPart >= LONGLONG(sizeof(Header)))
+    {
+        size = std::size_t(length.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (mapping)
+    {
+        base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);   // the view keeps the mapping alive
+    }
+    CloseHandle(file);
+    if (!base)
+    {
+        size = 0;
+        return false;
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size >= off_t(sizeof(Header)))
+    {
+        size = std::size_t(info.st_size);
+        base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED)
+            base = nullptr;
+    }
+    close(fd);  // the mapping stays valid
+    if (!base)
+    {
+        size = 0;
+        return false;
+    }
+#endif
+
+    // === Validate the header ===
+    const Header& header = *static_cast<const Header*>(base);
+    uint64_t distBytes = uint64_t(states.size()) * sizeof(uint32_t);
+    uint64_t words = (uint64_t(states.size()) * 3 + 63) / 64 + 1;   // as allocated by MoveArray
+
+    bool valid = std::memcmp(header.magic, Magic, sizeof(Magic)) == 0
+        && header.version == Version
+        && header.byteOrder == ByteOrderMark
+        && header.L == L && header.S == S
+        && header.stateCount == states.size()
+        && header.fileSize == size
+        && header.distOffset == sizeof(Header)
+        && header.movesOffset % 8 == 0
+        && header.movesOffset >= header.distOffset + distBytes
+        && header.movesWords == words
+        && header.movesOffset + words * sizeof(uint64_t) == size;
+
+    if (!valid)
+    {
+        Unmap();
+        return false;
+    }
+
+    dist = reinterpret_cast<const uint32_t*>(static_cast<const char*>(base) + header.distOffset);
+    moves = reinterpret_cast<const uint64_t*>(static_cast<const char*>(base) + header.movesOffset);
+    return true;
+}
+
+void SolutionCache::Unmap()
+{
+    if (base)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(base, size);
+#endif
+    }
+    base = nullptr;
+    size = 0;
+    dist = nullptr;
+    moves = nullptr;
+}
+
+/**
+ * @brief Undoes the mapped operations back from (W, 0), exactly like SolutionTable::Path.
+ */
+std::vector<Move> SolutionCache::Path(int W) const
+{
+    std::vector<Move> path;
+    uint32_t v = states.index(W, 0);
+    if (v == StateIndex::npos || dist[v] == SolutionTable::Unreachable)
+        return path;
+
+    path.reserve(dist[v]);
+    RebuildPath(L, S, W, [&](int big, int small) { return MoveArray::Get(moves, states.index(big, small)); }, path);
+    return path;
+}
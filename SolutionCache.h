@@ -0,0 +1,129 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include "SolutionTable.h"
+
+/**
+ * @brief A SolutionTable stored in a file and read back through a read-only memory mapping.
+ *
+ * The file for (L, S) holds a fixed header, the distance of every state (uint32) and the
+ * 3-bit operation that reached every state (packed 64-bit words, as in MoveArray), all in
+ * StateIndex order. Opening it maps the file and answers queries straight from the mapped
+ * pages: no BFS and no copy. If the file is missing, from another version, or does not
+ * match (L, S), the table is computed once with SolutionTable and written.
+ *
+ * Several processes can share the files: a writer builds the file under a temporary name
+ * unique to its process and then renames it over the final name, which replaces it in one
+ * step, so a reader only ever maps a complete file. Mapped files are never modified.
+ */
+class SolutionCache
+{
+public:
+
+    static constexpr uint32_t Version = 1;  ///< Bumped whenever the file layout changes
+
+    /**
+     * @brief Maps the cached table for (L, S) in `directory`, building and writing it first if needed.
+     *
+     * @param directory Directory holding the cache files (must exist)
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @throws std::runtime_error if the file cannot be written or mapped
+     */
+    SolutionCache(const std::string& directory, int _L, int _S);
+
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    /**
+     * @brief Destructor - unmaps the file.
+     */
+    ~SolutionCache();
+
+    /**
+     * @brief Writes a table to `path` in the cache format, replacing any existing file atomically.
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    static void Write(const SolutionTable& table, const std::string& path);
+
+    /**
+     * @brief Returns the file name used for (L, S) in `directory`.
+     */
+    static std::string FileName(const std::string& directory, int L, int S);
+
+    int GetL() const { return L; }  ///< Capacity of the large jug
+    int GetS() const { return S; }  ///< Capacity of the small jug
+
+    /**
+     * @brief True if this process built the file, false if an existing file was mapped.
+     */
+    bool Built() const { return built; }
+
+    /**
+     * @brief Returns the minimum number of operations to reach (W, 0), or SolutionTable::Unreachable.
+     */
+    uint32_t MinOperations(int W) const
+    {
+        uint32_t v = states.index(W, 0);
+        return (v == StateIndex::npos) ? SolutionTable::Unreachable : dist[v];
+    }
+
+    /**
+     * @brief Returns true if (W, 0) is reachable from (0, 0).
+     */
+    bool Solvable(int W) const { return MinOperations(W) != SolutionTable::Unreachable; }
+
+    /**
+     * @brief Returns the operations of a shortest solution for W, in order (the same path as SolutionTable).
+     */
+    std::vector<Move> Path(int W) const;
+
+    /**
+     * @brief Size of the mapped file, in bytes.
+     */
+    std::size_t MappedBytes() const { return size; }
+
+private:
+
+    /**
+     * @brief Layout of the start of a cache file. All fields are in the writer's byte order.
+     */
+    struct Header
+    {
+        char magic[8];          ///< "JUGTABLE"
+        uint32_t version;       ///< SolutionCache::Version
+        uint32_t byteOrder;     ///< ByteOrderMark as written, to reject files from other architectures
+        int32_t L, S;           ///< Capacities the table was computed for
+        uint32_t stateCount;    ///< StateIndex(L, S).size()
+        uint32_t reserved;      ///< Zero
+        uint64_t distOffset;    ///< Byte offset of the distance array
+        uint64_t movesOffset;   ///< Byte offset of the packed moves
+        uint64_t movesWords;    ///< Number of 64-bit words of packed moves
+        uint64_t fileSize;      ///< Total size of the file, in bytes
+    };
+
+    static constexpr char Magic[8] = { 'J', 'U', 'G', 'T', 'A', 'B', 'L', 'E' };
+    static constexpr uint32_t ByteOrderMark = 0x01020304;
+
+    int L, S;                       ///< Capacities of the large and small jugs
+    StateIndex states;              ///< Dense numbering of reachable states
+    bool built = false;             ///< This process wrote the file
+    void* base = nullptr;           ///< Start of the mapping
+    std::size_t size = 0;           ///< Length of the mapping
+    const uint32_t* dist = nullptr; ///< Mapped distance array
+    const uint64_t* moves = nullptr;///< Mapped packed moves
+
+    /**
+     * @brief Maps `path` and checks its header against (L, S).
+     *
+     * @return false if the file is missing or invalid (nothing stays mapped then)
+     */
+    bool Map(const std::string& path);
+
+    /**
+     * @brief Releases the mapping, if any.
+     */
+    void Unmap();
+};
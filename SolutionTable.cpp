@@ -0,0 +1,36 @@
+#include "SolutionTable.h"
+#include "BitsetSolver.h"
+#include "Common.h"
+
+/**
+ * @brief Sweeps from (0, 0) with the calling thread's BitsetSolver, straight into the table's arrays.
+ */
+SolutionTable::SolutionTable(int _L, int _S)
+    : L(_L), S(_S), states(_L, _S)
+{
+    thread_local BitsetSolver solver;
+
+    uint32_t n = states.size();
+    {
+        auto buildTimer = stats.Time(SearchPhase::Build);
+        dist.assign(n, Unreachable);
+        via = MoveArray(n);
+        stats.Allocate(MemoryBytes());
+    }
+    solver.Sweep(L, S, dist, via, stats);
+}
+
+/**
+ * @brief Undoes the recorded operations back from (W, 0) and returns the moves in order.
+ */
+std::vector<Move> SolutionTable::Path(int W) const
+{
+    std::vector<Move> path;
+    uint32_t v = states.index(W, 0);
+    if (v == StateIndex::npos || dist[v] == Unreachable)
+        return path;
+
+    path.reserve(dist[v]);
+    RebuildPath(L, S, W, [&](int big, int small) { return via.Get(states.index(big, small)); }, path);
+    return path;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include "StateIndex.h"
+#include "PackedArrays.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Shortest solutions from (0, 0) to every reachable state, for one pair of jugs.
+ *
+ * The constructor runs a single BFS from (0, 0) to completion and keeps its distance
+ * array and the 3-bit operation that reached each state. Afterwards the minimum number
+ * of operations for any target W is an O(1) lookup, and the path for any W is read back
+ * with InverseMove without searching again.
+ *
+ * The BFS is BitsetSolver::Sweep, which expands 64 boundary states per word operation. It
+ * settles ties between parents of the same level in its own order, so a path has Way1's
+ * length but may differ from Way1's sequence.
+ */
+class SolutionTable
+{
+public:
+
+    static constexpr uint32_t Unreachable = UINT32_MAX;  ///< Distance of an unreachable state
+
+    /**
+     * @brief Runs the BFS from (0, 0) over all reachable states, with a BitsetSolver kept per thread.
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     */
+    SolutionTable(int _L, int _S);
+
+    int GetL() const { return L; }  ///< Capacity of the large jug
+    int GetS() const { return S; }  ///< Capacity of the small jug
+
+    /**
+     * @brief Returns the minimum number of operations to reach (W, 0), or Unreachable.
+     */
+    uint32_t MinOperations(int W) const
+    {
+        uint32_t v = states.index(W, 0);
+        return (v == StateIndex::npos) ? Unreachable : dist[v];
+    }
+
+    /**
+     * @brief Returns true if (W, 0) is reachable from (0, 0).
+     */
+    bool Solvable(int W) const { return MinOperations(W) != Unreachable; }
+
+    /**
+     * @brief Returns the operations of a shortest solution for W, in order.
+     *
+     * @return The moves from (0, 0) to (W, 0); empty if W = 0 or there is no solution.
+     */
+    std::vector<Move> Path(int W) const;
+
+    /**
+     * @brief Distance of every state from (0, 0), indexed by StateIndex, for writing the table to a file.
+     */
+    std::span<const uint32_t> Distances() const { return dist; }
+
+    /**
+     * @brief The operation that reached every state, for writing the table to a file.
+     */
+    const MoveArray& Moves() const { return via; }
+
+    /**
+     * @brief Counters and phase times of the BFS that built the table (all zero unless JUG_STATS is set).
+     */
+    const SearchStats& Stats() const { return stats; }
+
+    /**
+     * @brief Approximate memory used by the table, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        return dist.size() * sizeof(uint32_t) + via.MemoryBytes();
+    }
+
+private:
+    int L, S;                       ///< Capacities of the large and small jugs
+    StateIndex states;              ///< Dense numbering of reachable states
+    std::vector<uint32_t> dist;     ///< Distance from (0, 0), or Unreachable
+    MoveArray via;                  ///< Operation that leads from the parent to the state
+    SearchStats stats;              ///< Counters of the construction (empty unless JUG_STATS is set)
+};
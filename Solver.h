@@ -0,0 +1,420 @@
+#pragma once
+#include "Common.h"
+#include "FlatHashMap.h"
+#include "ParallelBfs.h"
+#include <array>
+#include <optional>
+
+/**
+ * @brief Generalization of the water jug problem to N jugs.
+ *
+ * A state is packed into one uint64_t in mixed radix: jug i holding a_i contributes
+ * a_i * stride[i], where stride[i] is the product of (capacity[j] + 1) over j < i.
+ * The legal operations are filling or emptying any jug and pouring any jug into any
+ * other one (N*(N-1) pours), and are generated into caller-provided arrays without
+ * allocating. The goal is any predicate on a state, e.g. JugHolds.
+ *
+ * Three search strategies are available so they can be compared:
+ * - PrebuiltGraph: builds the CSR graph of all states first, then runs BFS over it (as in Way1).
+ * - OnTheFly: generates successors during the BFS and keeps only visited states in a hash map (as in Way2).
+ * - Parallel: runs ParallelBfs over all states, numbered by their packed value, with
+ *   successors and predecessors generated on the fly. With three or more jugs the BFS levels
+ *   hold many thousands of states, so every level is shared among all cores.
+ */
+template <int N>
+class Solver
+{
+    static_assert(N >= 2, "Solver needs at least two jugs");
+
+public:
+    using State = uint64_t;  ///< Packed mixed-radix state
+
+    /**
+     * @brief One operation: fill a jug, empty a jug, or pour one jug into another.
+     */
+    struct Move
+    {
+        enum Kind : uint8_t { Fill, Empty, Pour } kind;
+        uint8_t from;   ///< Jug that is filled, emptied or poured from
+        uint8_t to;     ///< Jug that is poured into (Pour only)
+    };
+
+    /**
+     * @brief Search strategy.
+     */
+    enum class Strategy
+    {
+        PrebuiltGraph,  ///< Build all states and edges first, then search
+        OnTheFly,       ///< Generate successors while searching
+        Parallel        ///< Multithreaded direction-optimizing BFS (ParallelBfs)
+    };
+
+    static constexpr int MaxMoves = 2 * N + N * (N - 1);  ///< Upper bound on the successors of a state
+
+    /**
+     * @brief Goal predicate: a given jug holds a given amount, whatever the other jugs hold.
+     */
+    struct JugHolds
+    {
+        const Solver* solver;
+        int jug;
+        uint32_t amount;
+
+        bool operator()(State s) const { return solver->Amount(s, jug) == amount; }
+    };
+
+    /**
+     * @brief Constructs the solver for the given capacities.
+     *
+     * @param _capacity Capacity of each jug
+     * @throws std::length_error if the number of states does not fit a uint64_t
+     */
+    explicit Solver(const std::array<uint32_t, N>& _capacity) : capacity(_capacity)
+    {
+        uint64_t product = 1;
+        for (int i = 0; i < N; i++)
+        {
+            stride[i] = product;
+            uint64_t radix = uint64_t(capacity[i]) + 1;
+            if (product > UINT64_MAX / radix)
+                throw std::length_error("Solver: state space too large for a 64-bit state");
+            product *= radix;
+        }
+        stateCount = product;
+    }
+
+    /**
+     * @brief Total number of states, (capacity[0] + 1) * ... * (capacity[N - 1] + 1).
+     */
+    uint64_t StateCount() const { return stateCount; }
+
+    /**
+     * @brief Returns true if the PrebuiltGraph strategy can index the edges (uint32 offsets).
+     */
+    bool GraphFits() const { return stateCount < UINT32_MAX / MaxMoves; }
+
+    /**
+     * @brief Upper bound on the memory the PrebuiltGraph strategy allocates, in bytes: offsets,
+     * parents and queue per state, and MaxMoves edge targets per state.
+     */
+    uint64_t GraphBytes() const { return (stateCount * (MaxMoves + 3) + 1) * sizeof(uint32_t); }
+
+    /**
+     * @brief Packs the amounts of all jugs into a state.
+     */
+    State Encode(const std::array<uint32_t, N>& amounts) const
+    {
+        State s = 0;
+        for (int i = 0; i < N; i++)
+            s += amounts[i] * stride[i];
+        return s;
+    }
+
+    /**
+     * @brief Returns the amount in one jug.
+     */
+    uint32_t Amount(State s, int jug) const
+    {
+        return uint32_t((s / stride[jug]) % (uint64_t(capacity[jug]) + 1));
+    }
+
+    /**
+     * @brief Unpacks a state into the amounts of all jugs.
+     */
+    std::array<uint32_t, N> Decode(State s) const
+    {
+        std::array<uint32_t, N> amounts;
+        for (int i = 0; i < N; i++)
+        {
+            amounts[i] = uint32_t(s % (uint64_t(capacity[i]) + 1));
+            s /= uint64_t(capacity[i]) + 1;
+        }
+        return amounts;
+    }
+
+    /**
+     * @brief Writes every state reachable from s by one legal operation.
+     *
+     * @param s The state
+     * @param out Receives up to MaxMoves successor states
+     * @param moves Receives the operation leading to each successor
+     * @return Number of successors written
+     */
+    int Successors(State s, State* out, Move* moves) const
+    {
+        std::array<uint32_t, N> a = Decode(s);
+        int count = 0;
+
+        // Fills and empties
+        for (int i = 0; i < N; i++)
+        {
+            if (a[i] < capacity[i])
+            {
+                out[count] = s + (capacity[i] - a[i]) * stride[i];
+                moves[count++] = { Move::Fill, uint8_t(i), 0 };
+            }
+            if (a[i] > 0)
+            {
+                out[count] = s - a[i] * stride[i];
+                moves[count++] = { Move::Empty, uint8_t(i), 0 };
+            }
+        }
+
+        // Pours from jug i into jug j
+        for (int i = 0; i < N; i++)
+        {
+            if (a[i] == 0)
+                continue;
+            for (int j = 0; j < N; j++)
+            {
+                if (j == i || a[j] == capacity[j])
+                    continue;
+                uint64_t pour = std::min(a[i], capacity[j] - a[j]);
+                out[count] = s - pour * stride[i] + pour * stride[j];
+                moves[count++] = { Move::Pour, uint8_t(i), uint8_t(j) };
+            }
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Calls `emit(u)` for every state u that leads to s by one legal operation, until emit returns true.
+     *
+     * Filling or emptying jug i forgets how much it held, so each of those has up to capacity[i]
+     * predecessors. A pour from i into j either emptied i, or filled j (when i is not empty
+     * afterwards); the two cases give distinct predecessors, so none is reported twice.
+     *
+     * @return true if emit returned true
+     */
+    template <typename Emit>
+    bool ForEachPredecessor(State s, Emit emit) const
+    {
+        std::array<uint32_t, N> a = Decode(s);
+
+        for (int i = 0; i < N; i++)
+        {
+            if (a[i] == capacity[i])            // filled: jug i held less before
+                for (uint64_t before = 0; before < capacity[i]; before++)
+                    if (emit(s - (capacity[i] - before) * stride[i]))
+                        return true;
+            if (a[i] == 0)                      // emptied: jug i held something before
+                for (uint64_t before = 1; before <= capacity[i]; before++)
+                    if (emit(s + before * stride[i]))
+                        return true;
+        }
+
+        for (int i = 0; i < N; i++)
+        {
+            for (int j = 0; j < N; j++)
+            {
+                if (j == i)
+                    continue;
+
+                // Pour of p from i into j: i was emptied (a[i] = 0), or else j was filled
+                uint64_t most = 0;
+                if (a[i] == 0)
+                    most = std::min(a[j], capacity[i]);
+                else if (a[j] == capacity[j])
+                    most = std::min(capacity[j], capacity[i] - a[i]);
+
+                for (uint64_t p = 1; p <= most; p++)
+                    if (emit(s + p * stride[i] - p * stride[j]))
+                        return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Finds a shortest sequence of operations from the all-empty state to a goal state.
+     *
+     * @param goal Predicate on a state, e.g. JugHolds
+     * @param strategy Search strategy
+     * @param engine Engine used by the Parallel strategy, whose workers are kept between calls
+     *               (if null, one is started for this call)
+     * @param searchNanoseconds If not null, receives the time of the BFS alone, without building
+     *                          the graph (PrebuiltGraph only)
+     * @return The moves, or std::nullopt if no goal state is reachable
+     */
+    template <typename Goal>
+    std::optional<std::vector<Move>> Solve(Goal goal, Strategy strategy, ParallelBfs* engine = nullptr,
+                                           long long* searchNanoseconds = nullptr) const
+    {
+        switch (strategy)
+        {
+        case Strategy::PrebuiltGraph: return SolveGraph(goal, searchNanoseconds);
+        case Strategy::OnTheFly:      return SolveOnTheFly(goal);
+        default:                      return SolveParallel(goal, engine);
+        }
+    }
+
+    /**
+     * @brief Returns the description of an operation, e.g. "Transfer from jug 1 to jug 3".
+     */
+    static std::string MoveName(const Move& move)
+    {
+        switch (move.kind)
+        {
+        case Move::Fill:  return "Fill jug " + std::to_string(move.from + 1);
+        case Move::Empty: return "Empty jug " + std::to_string(move.from + 1);
+        default:          return "Transfer from jug " + std::to_string(move.from + 1) + " to jug " + std::to_string(move.to + 1);
+        }
+    }
+
+private:
+    std::array<uint32_t, N> capacity;   ///< Capacity of each jug
+    std::array<uint64_t, N> stride;     ///< Place value of each jug in the packed state
+    uint64_t stateCount;                ///< Number of states
+
+    /**
+     * @brief Returns the operation that leads from `from` to `to`.
+     */
+    Move MoveBetween(State from, State to) const
+    {
+        State next[MaxMoves];
+        Move moves[MaxMoves];
+        int count = Successors(from, next, moves);
+        for (int i = 0; i < count; i++)
+            if (next[i] == to)
+                return moves[i];
+        return {};
+    }
+
+    /**
+     * @brief Builds the move list by following parents back from the goal.
+     */
+    template <typename Parent>
+    std::vector<Move> Reconstruct(State goal, Parent parent) const
+    {
+        std::vector<State> path = { goal };
+        while (path.back() != 0)
+            path.push_back(parent(path.back()));
+
+        std::vector<Move> moves;
+        for (size_t i = path.size() - 1; i > 0; i--)
+            moves.push_back(MoveBetween(path[i], path[i - 1]));
+        return moves;
+    }
+
+    /**
+     * @brief PrebuiltGraph strategy: CSR graph of every state, then BFS over dense arrays.
+     */
+    template <typename Goal>
+    std::optional<std::vector<Move>> SolveGraph(Goal goal, long long* searchNanoseconds) const
+    {
+        if (!GraphFits())
+            throw std::length_error("Solver: state space too large for a prebuilt graph");
+
+        uint32_t n = uint32_t(stateCount);
+        State next[MaxMoves];
+        Move moves[MaxMoves];
+
+        // === Build the graph in two passes: out-degrees, then targets ===
+        std::vector<uint32_t> offsets(size_t(n) + 1, 0);
+        for (uint32_t v = 0; v < n; v++)
+            offsets[v + 1] = offsets[v] + uint32_t(Successors(v, next, moves));
+
+        std::vector<uint32_t> targets(offsets[n]);
+        for (uint32_t v = 0; v < n; v++)
+        {
+            int count = Successors(v, next, moves);
+            for (int i = 0; i < count; i++)
+                targets[offsets[v] + i] = uint32_t(next[i]);
+        }
+
+        // === BFS from the all-empty state ===
+        auto start = std::chrono::steady_clock::now();
+        auto stopClock = [&]
+        {
+            if (searchNanoseconds)
+                *searchNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        };
+        std::vector<uint32_t> prev(n, UINT32_MAX);
+        std::vector<uint32_t> Q = { 0 };
+        prev[0] = 0;
+
+        for (size_t head = 0; head < Q.size(); head++)
+        {
+            uint32_t U = Q[head];
+            if (goal(State(U)))
+            {
+                stopClock();
+                return Reconstruct(U, [&](State v) { return State(prev[v]); });
+            }
+
+            for (uint32_t e = offsets[U]; e < offsets[U + 1]; e++)
+            {
+                uint32_t V = targets[e];
+                if (prev[V] == UINT32_MAX)
+                {
+                    prev[V] = U;
+                    Q.push_back(V);
+                }
+            }
+        }
+        stopClock();
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Parallel strategy: ParallelBfs with the packed states as dense indices.
+     */
+    template <typename Goal>
+    std::optional<std::vector<Move>> SolveParallel(Goal goal, ParallelBfs* engine) const
+    {
+        if (stateCount >= UINT32_MAX)
+            throw std::length_error("Solver: state space too large for the parallel strategy");
+
+        std::optional<ParallelBfs> own;
+        if (!engine)
+            engine = &own.emplace();
+
+        uint32_t found = engine->Search(uint32_t(stateCount), 0,
+            [&](uint32_t v) { return goal(State(v)); },
+            [&](uint32_t u, auto emit)
+            {
+                State next[MaxMoves];
+                Move moves[MaxMoves];
+                int count = Successors(u, next, moves);
+                for (int i = 0; i < count; i++)
+                    emit(uint32_t(next[i]));
+            },
+            [&](uint32_t v, auto emit) { ForEachPredecessor(v, [&](State u) { return emit(uint32_t(u)); }); });
+
+        if (found == ParallelBfs::None)
+            return std::nullopt;
+        return Reconstruct(found, [&](State v) { return State(engine->Parent(uint32_t(v))); });
+    }
+
+    /**
+     * @brief OnTheFly strategy: BFS that generates successors as it goes and remembers
+     * the parent of each visited state in a FlatHashMap, as Way2 does.
+     *
+     * The largest state is StateCount() - 1 < UINT64_MAX, so no state collides with FlatHashMap::EmptyKey.
+     */
+    template <typename Goal>
+    std::optional<std::vector<Move>> SolveOnTheFly(Goal goal) const
+    {
+        FlatHashMap parent;
+        parent.InsertIfAbsent(0, 0);
+        std::vector<State> Q = { 0 };
+        State next[MaxMoves];
+        Move moves[MaxMoves];
+
+        for (size_t head = 0; head < Q.size(); head++)
+        {
+            State U = Q[head];
+            if (goal(U))
+                return Reconstruct(U, [&](State v) { return *parent.Find(v); });
+
+            int count = Successors(U, next, moves);
+            for (int i = 0; i < count; i++)
+            {
+                if (parent.InsertIfAbsent(next[i], U))
+                    Q.push_back(next[i]);
+            }
+        }
+        return std::nullopt;
+    }
+};
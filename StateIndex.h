@@ -0,0 +1,140 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+
+/**
+ * @brief Maps the reachable states of the water jug problem to a dense range of indices.
+ *
+ * Every legal operation leaves at least one jug either full or empty, so apart from
+ * (0, 0) every reachable state lies on the boundary of the (L + 1) x (S + 1) grid.
+ * Only those 2 * (L + S) boundary states get an index; interior states map to npos.
+ *
+ * Indices follow lexicographic order of (big, small):
+ * - big = 0:         all small in [0, S]
+ * - 0 < big < L:     small = 0 and small = S
+ * - big = L:         all small in [0, S]
+ *
+ * Requires L > S >= 0.
+ */
+class StateIndex
+{
+public:
+
+    static constexpr uint32_t npos = UINT32_MAX;  ///< Index of a state outside the boundary
+
+    /**
+     * @brief Constructs the indexer for the given jug capacities.
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @throws std::length_error if the boundary does not fit 32-bit indices
+     */
+    constexpr StateIndex(int _L, int _S) : L(_L), S(_S)
+    {
+        if (!Fits(L, S))
+            throw std::length_error("StateIndex: state space too large for 32-bit indices");
+
+        perRow = (S > 0) ? 2 : 1;
+        lastRow = uint64_t(S + 1) + uint64_t(L - 1) * perRow;
+        n = uint32_t(lastRow + uint64_t(S + 1));
+    }
+
+    /**
+     * @brief Returns true if the boundary of (L, S) fits 32-bit indices, i.e. the constructor will not throw.
+     */
+    static constexpr bool Fits(int L, int S)
+    {
+        uint64_t count = uint64_t(S + 1) + uint64_t(L - 1) * (S > 0 ? 2 : 1) + uint64_t(S + 1);
+        return count < npos;
+    }
+
+    /**
+     * @brief Returns the number of indexed (boundary) states.
+     */
+    constexpr uint32_t size() const { return n; }
+
+    /**
+     * @brief Returns the dense index of a state.
+     *
+     * @param big Amount in the large jug
+     * @param small Amount in the small jug
+     * @return Index of the state, or npos if it is out of bounds or not on the boundary.
+     */
+    constexpr uint32_t index(int big, int small) const
+    {
+        if (big < 0 || big > L || small < 0 || small > S)
+            return npos;
+
+        if (big == 0)
+            return uint32_t(small);
+        if (big == L)
+            return uint32_t(lastRow) + uint32_t(small);
+        if (small == 0)
+            return uint32_t(S + 1) + uint32_t(big - 1) * perRow;
+        if (small == S)
+            return uint32_t(S + 1) + uint32_t(big - 1) * perRow + 1;
+
+        return npos; // interior state, never reachable
+    }
+
+    /**
+     * @brief Returns the state with the given dense index.
+     *
+     * @param v Index in [0, size())
+     * @return The state (big, small)
+     */
+    constexpr std::pair<int, int> state(uint32_t v) const
+    {
+        if (v <= uint32_t(S))
+            return { 0, int(v) };
+        if (v >= lastRow)
+            return { L, int(v - lastRow) };
+
+        uint32_t r = v - uint32_t(S + 1);
+        return { int(r / perRow) + 1, (r % perRow) ? S : 0 };
+    }
+
+private:
+    int L, S;           ///< Capacities of the large and small jugs
+    uint32_t perRow;    ///< Boundary states per interior row (2, or 1 when S = 0)
+    uint64_t lastRow;   ///< Index of (L, 0)
+    uint32_t n;         ///< Number of boundary states
+};
+
+/**
+ * @brief Calls `emit(move, index)` for every state reachable from state v by one legal operation,
+ * in index order.
+ *
+ * This is the transition rule of the engines that visit neighbors in lexicographic order
+ * (StateIndex numbers states lexicographically): Graph::generateAllEdges, JugSolver and
+ * FixedSolver all go through it, so they produce the same paths as Way1.
+ */
+template <typename Emit>
+constexpr void ForEachNeighbor(const StateIndex& states, int L, int S, uint32_t v, Emit emit)
+{
+    auto [big, small] = states.state(v);
+    uint32_t targets[MoveCount];
+    Move moves[MoveCount];
+    int count = 0;
+    int toBig = 0, toSmall = 0;
+
+    for (int m = 0; m < MoveCount; m++)
+    {
+        if (!ApplyMove(Move(m), L, S, big, small, toBig, toSmall))
+            continue;
+
+        // Insertion sort as the neighbors come, at most 6 entries
+        uint32_t to = states.index(toBig, toSmall);
+        int i = count++;
+        for (; i > 0 && targets[i - 1] > to; i--)
+        {
+            targets[i] = targets[i - 1];
+            moves[i] = moves[i - 1];
+        }
+        targets[i] = to;
+        moves[i] = Move(m);
+    }
+
+    for (int i = 0; i < count; i++)
+        emit(moves[i], targets[i]);
+}
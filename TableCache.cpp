@@ -0,0 +1,90 @@
+#include "TableCache.h"
+#include "StateIndex.h"
+
+/**
+ * @brief Looks the table up; on a miss, either joins a computation already in flight or
+ * computes the table outside the lock and inserts it.
+ */
+TableCache::TablePtr TableCache::Get(int L, int S, bool* computed)
+{
+    Key key = { L, S };
+    if (computed)
+        *computed = false;
+    std::promise<TablePtr> promise;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            recency.splice(recency.begin(), recency, it->second.recent);   // mark as most recent
+            return it->second.table;
+        }
+
+        auto inFlight = pending.find(key);
+        if (inFlight != pending.end())
+        {
+            std::shared_future<TablePtr> result = inFlight->second;
+            lock.unlock();
+            return result.get();
+        }
+
+        pending.emplace(key, promise.get_future().share());
+    }
+
+    // === Compute the table without holding the lock ===
+    TablePtr table;
+    try
+    {
+        table = std::make_shared<const SolutionTable>(L, S);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        promise.set_exception(std::current_exception());
+        pending.erase(key);
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    recency.push_front(key);
+    entries.emplace(key, Entry{ table, recency.begin() });
+    usedBytes += table->MemoryBytes();
+    Evict(key);
+
+    promise.set_value(table);
+    pending.erase(key);
+    if (computed)
+        *computed = true;
+    return table;
+}
+
+/**
+ * @brief Removes entries from the back of the recency list.
+ */
+void TableCache::Evict(const Key& keep)
+{
+    while (usedBytes > budgetBytes && !recency.empty())
+    {
+        Key oldest = recency.back();
+        if (oldest == keep)
+            break;  // the only table left is the one just inserted
+
+        auto it = entries.find(oldest);
+        usedBytes -= it->second.table->MemoryBytes();
+        entries.erase(it);
+        recency.pop_back();
+    }
+}
+
+/**
+ * @brief A table stores a uint32 distance and 3 bits of move per state (see SolutionTable::MemoryBytes).
+ */
+std::size_t TableCache::EstimateBytes(int L, int S)
+{
+    if (!StateIndex::Fits(L, S))
+        return SIZE_MAX;
+    std::size_t n = StateIndex(L, S).size();
+    return n * sizeof(uint32_t) + ((n * 3 + 63) / 64 + 1) * sizeof(uint64_t);
+}
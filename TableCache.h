@@ -0,0 +1,83 @@
+#pragma once
+#include "Common.h"
+#include "SolutionTable.h"
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Thread-safe LRU cache of SolutionTables, bounded by a memory budget.
+ *
+ * Tables are handed out as shared pointers, so a table evicted while a thread still
+ * uses it stays alive until that thread lets go. When several threads ask for the same
+ * missing (L, S) at once, only the first computes it and the others wait for its result.
+ */
+class TableCache
+{
+public:
+
+    using TablePtr = std::shared_ptr<const SolutionTable>;
+
+    /**
+     * @brief Creates an empty cache.
+     *
+     * @param _budgetBytes Total SolutionTable::MemoryBytes the cache may hold
+     */
+    explicit TableCache(std::size_t _budgetBytes) : budgetBytes(_budgetBytes) {}
+
+    /**
+     * @brief Returns the table for (L, S), computing it if it is not cached.
+     *
+     * The most recently used tables are kept; older ones are evicted until the cache fits
+     * its budget again. The table just returned is never evicted by its own insertion.
+     *
+     * @param computed If not null, set to true if this call ran the BFS, false if the table
+     *                 was cached or computed by another thread
+     */
+    TablePtr Get(int L, int S, bool* computed = nullptr);
+
+    /**
+     * @brief Estimated MemoryBytes of the table for (L, S), without computing it.
+     *
+     * @return SIZE_MAX if StateIndex cannot index the states of (L, S), so no budget admits it
+     */
+    static std::size_t EstimateBytes(int L, int S);
+
+    std::size_t BudgetBytes() const { return budgetBytes; }  ///< Memory budget, in bytes
+
+    /**
+     * @brief Memory held by the cached tables, in bytes.
+     */
+    std::size_t UsedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return usedBytes;
+    }
+
+private:
+
+    using Key = std::pair<int, int>;
+
+    /**
+     * @brief A cached table and its position in the recency list.
+     */
+    struct Entry
+    {
+        TablePtr table;
+        std::list<Key>::iterator recent;
+    };
+
+    std::size_t budgetBytes;                            ///< Memory budget, in bytes
+    std::size_t usedBytes = 0;                          ///< Sum of the cached tables' sizes
+    mutable std::mutex mutex;                           ///< Guards everything below
+    std::map<Key, Entry> entries;                       ///< Cached tables
+    std::list<Key> recency;                             ///< Keys, most recently used first
+    std::map<Key, std::shared_future<TablePtr>> pending;///< Tables being computed right now
+
+    /**
+     * @brief Drops least recently used tables, except `keep`, until the cache fits its budget.
+     */
+    void Evict(const Key& keep);
+};
@@ -1,47 +1,88 @@
-#pragma once
-#include "Graph.h"
-#include "Common.h"
-/**
- * @brief Implements the first solution method (Way1) for solving the water jug problem.
- *
- * This method constructs the full state graph in advance and performs
- * a breadth-first search (BFS) to find the shortest sequence of operations
- * that results in exactly W units in the large jug.
- */
-class Way1
-{
-private:
-    int L, S, W;     ///< Capacities of the large and small jugs, and the desired target amount
-    Graph* G1;       ///< Pointer to the graph representing all valid jug states
-
-    /**
-     * @brief Performs a BFS search on the full graph to find a solution path.
-     *
-     * The BFS finds the shortest path from the initial state (0,0) to the target state (W,0),
-     * and prints the number of operations and the exact sequence of actions taken.
-     */
-    void BFS();
-
-public:
-    /**
-     * @brief Constructor - builds the graph and initiates the BFS process.
-     *
-     * @param _L Capacity of the large jug
-     * @param _S Capacity of the small jug
-     * @param _W Target amount to be reached in the large jug
-     */
-    Way1(int _L, int _S, int _W)
-        : L(_L), S(_S), W(_W)
-    {
-        G1 = new Graph(L, S);
-        BFS();
-    }
-
-    /**
-     * @brief Destructor - releases the dynamically allocated graph.
-     */
-    ~Way1()
-    {
-        delete G1;
-    }
-};
+#pragma once
+#include "Graph.h"
+#include "GraphArena.h"
+#include "PackedArrays.h"
+#include "PathWriter.h"
+#include "SearchStats.h"
+#include "Common.h"
+/**
+ * @brief Implements the first solution method (Way1) for solving the water jug problem.
+ *
+ * This method constructs the full state graph in advance and performs
+ * a breadth-first search (BFS) to find the shortest sequence of operations
+ * that results in exactly W units in the large jug.
+ * The graph's arrays come from the thread's GraphArena, so successive queries reuse the same memory.
+ */
+class Way1
+{
+private:
+    int L, S, W;     ///< Capacities of the large and small jugs, and the desired target amount
+    Graph* G1;       ///< Pointer to the graph representing all valid jug states
+    bool print;      ///< Print the solution (false when only timing the search)
+    PathFormat format;                ///< How the solution is printed
+    long long buildNanoseconds = 0;   ///< Duration of the graph build
+    long long searchNanoseconds = 0;  ///< Duration of the BFS loop, excluding graph build and output
+    long long pathNanoseconds = 0;    ///< Duration of the walk back that counts the operations, excluding output
+    SearchStats stats;                ///< Counters and phase times (empty unless JUG_STATS is set)
+
+    /**
+     * @brief Performs a BFS search on the full graph to find a solution path.
+     *
+     * The BFS finds the shortest path from the initial state (0,0) to the target state (W,0),
+     * and prints the number of operations and the exact sequence of actions taken.
+     */
+    void BFS();
+
+public:
+    /**
+     * @brief Constructor - builds the graph and initiates the BFS process.
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @param _W Target amount to be reached in the large jug
+     * @param _print Print the number of operations and the moves
+     * @param _format How the solution is printed
+     */
+    Way1(int _L, int _S, int _W, bool _print = true, PathFormat _format = PathFormat::Full)
+        : L(_L), S(_S), W(_W), print(_print), format(_format)
+    {
+        auto buildStart = std::chrono::steady_clock::now();
+        G1 = new Graph(L, S, &GraphArena::ThreadLocal());
+        buildNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - buildStart).count();
+        BFS();
+    }
+
+    /**
+     * @brief Time spent in the BFS loop itself, excluding graph build and output.
+     */
+    long long SearchMicroseconds() const { return searchNanoseconds / 1000; }
+
+    /**
+     * @brief Time spent building the graph, in nanoseconds.
+     */
+    long long BuildNanoseconds() const { return buildNanoseconds; }
+
+    /**
+     * @brief Time spent in the BFS loop itself, in nanoseconds.
+     */
+    long long SearchNanoseconds() const { return searchNanoseconds; }
+
+    /**
+     * @brief Time spent walking the path back through the recorded moves, in nanoseconds (0 if not solved).
+     */
+    long long PathNanoseconds() const { return pathNanoseconds; }
+
+    /**
+     * @brief Counters and phase times of the query (all zero unless JUG_STATS is set).
+     */
+    const SearchStats& Stats() const { return stats; }
+
+    /**
+     * @brief Destructor - releases the dynamically allocated graph.
+     */
+    ~Way1()
+    {
+        delete G1;
+    }
+};
@@ -1,57 +1,88 @@
-#pragma once
-#include <unordered_set>
-#include <utility>
-#include <functional>
-#include <list>
-
-/**
- * @brief Hash function for std::pair<int, int> to be used in unordered_set/map.
- */
-struct pair_hash
-{
-    std::size_t operator()(const std::pair<int, int>& p) const
-    {
-        return std::hash<int>()(p.first) ^ (std::hash<int>()(p.second) << 1);
-    }
-};
-
-/**
- * @brief Second implementation of the water jug problem using on-the-fly graph generation.
- *
- * This class avoids building the full state graph in advance. Instead, it generates neighbors dynamically during BFS.
- */
-class Way2
-{
-private:
-    int L, S, W;   ///< Large jug size, small jug size, target amount
-    std::unordered_set<std::pair<int, int>, pair_hash> unorderedSet; ///< Set of already visited states
-
-    /**
-     * @brief Dynamically calculates valid neighbor states from a given state.
-     *
-     * @param vertex The current state (big, small)
-     * @return List of reachable states, sorted lexicographically
-     */
-    std::list<std::pair<int, int>> CalculateAdjList(std::pair<int, int> vertex);
-
-    /**
-     * @brief Runs BFS starting from (0, 0), generating states and transitions on-the-fly.
-     */
-    void BFS();
-
-public:
-    /**
-     * @brief Constructor - initializes state and starts BFS immediately.
-     */
-    Way2(int _L, int _S, int _W) : L(_L), S(_S), W(_W)
-    {
-        BFS();
-    }
-
-    /**
-     * @brief Destructor - currently does nothing as all memory is managed automatically.
-     */
-    ~Way2() {}
-};
-
-
+#pragma once
+#include <utility>
+#include <list>
+#include "FlatHashMap.h"
+#include "Move.h"
+#include "PathWriter.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Second implementation of the water jug problem using on-the-fly graph generation.
+ *
+ * This class avoids building the full state graph in advance. Instead, it generates neighbors dynamically during BFS.
+ * Only the visited states are stored, in a flat hash map from each state to the operation that
+ * reached it, so memory grows with the number of states actually visited rather than with the
+ * capacities. The path is walked backwards from (W, 0) with InverseMove, straight into the output buffer.
+ */
+class Way2
+{
+private:
+    int L, S, W;   ///< Large jug size, small jug size, target amount
+    FlatHashMap visited; ///< Already visited states, mapped to the Move that reached them
+    bool print;          ///< Print the solution (false when only timing the search)
+    PathFormat format;   ///< How the solution is printed
+    long long searchNanoseconds = 0;  ///< Duration of the BFS loop, excluding output
+    long long pathNanoseconds = 0;    ///< Duration of the walk back that counts the operations, excluding output
+    uint64_t expanded = 0;            ///< States taken off the queue, counted even without JUG_STATS
+    SearchStats stats;                ///< Counters and phase times (empty unless JUG_STATS is set)
+
+    /**
+     * @brief Packs a state into the 64-bit key used by the visited map.
+     */
+    static uint64_t Pack(std::pair<int, int> state)
+    {
+        return (uint64_t(uint32_t(state.first)) << 32) | uint32_t(state.second);
+    }
+
+    /**
+     * @brief Dynamically calculates valid neighbor states from a given state.
+     *
+     * @param vertex The current state (big, small)
+     * @return List of reachable states, sorted lexicographically
+     */
+    std::list<std::pair<int, int>> CalculateAdjList(std::pair<int, int> vertex);
+
+    /**
+     * @brief Runs BFS starting from (0, 0), generating states and transitions on-the-fly.
+     */
+    void BFS();
+
+public:
+    /**
+     * @brief Constructor - initializes state and starts BFS immediately.
+     *
+     * @param _print Print the number of operations and the moves
+     * @param _format How the solution is printed
+     */
+    Way2(int _L, int _S, int _W, bool _print = true, PathFormat _format = PathFormat::Full)
+        : L(_L), S(_S), W(_W), print(_print), format(_format)
+    {
+        BFS();
+    }
+
+    /**
+     * @brief Time spent in the BFS loop, including neighbor generation, in nanoseconds.
+     */
+    long long SearchNanoseconds() const { return searchNanoseconds; }
+
+    /**
+     * @brief Time spent walking the path back through the recorded moves, in nanoseconds (0 if not solved).
+     */
+    long long PathNanoseconds() const { return pathNanoseconds; }
+
+    /**
+     * @brief Number of states the BFS took off its queue, the goal included.
+     */
+    uint64_t StatesExpanded() const { return expanded; }
+
+    /**
+     * @brief Counters and phase times of the query (all zero unless JUG_STATS is set).
+     */
+    const SearchStats& Stats() const { return stats; }
+
+    /**
+     * @brief Destructor - currently does nothing as all memory is managed automatically.
+     */
+    ~Way2() {}
+};
+
@@ -0,0 +1,241 @@
+#include "Way3.h"
+#include "Common.h"
+
+/**
+ * @brief Greatest common divisor (Euclid). gcd(a, 0) = a.
+ */
+static uint64_t Gcd(uint64_t a, uint64_t b)
+{
+    while (b != 0)
+    {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief Inverse of a modulo m by the extended Euclidean algorithm.
+ *
+ * Requires gcd(a, m) = 1 and m <= 2^62, so all intermediate values fit in int64_t.
+ * Returns 0 when m = 1.
+ */
+static uint64_t ModInverse(uint64_t a, uint64_t m)
+{
+    int64_t oldR = int64_t(a % m), r = int64_t(m);
+    int64_t oldX = 1, x = 0;
+
+    while (r != 0)
+    {
+        int64_t q = oldR / r;
+        int64_t t = oldR - q * r; oldR = r; r = t;
+        t = oldX - q * x; oldX = x; x = t;
+    }
+
+    return uint64_t((oldX % int64_t(m) + int64_t(m)) % int64_t(m));
+}
+
+/**
+ * @brief Computes floor(a * b / c) and (a * b) mod c without 128-bit arithmetic.
+ *
+ * Uses double-and-add over the bits of b. Requires a <= c and c <= 2^62,
+ * so the running remainder never exceeds 2^63.
+ */
+static uint64_t MulDiv(uint64_t a, uint64_t b, uint64_t c, uint64_t& rem)
+{
+    uint64_t q = 0, r = 0;
+
+    for (int bit = 63; bit >= 0; bit--)
+    {
+        q <<= 1;
+        r <<= 1;
+        if (r >= c) { r -= c; q++; }
+
+        if ((b >> bit) & 1)
+        {
+            r += a;
+            if (r >= c) { r -= c; q++; }
+        }
+    }
+
+    rem = r;
+    return q;
+}
+
+/**
+ * @brief Computes (a * b) mod m without 128-bit arithmetic. Requires a <= m <= 2^62.
+ */
+static uint64_t MulMod(uint64_t a, uint64_t b, uint64_t m)
+{
+    uint64_t rem;
+    MulDiv(a, b, m, rem);
+    return rem;
+}
+
+/**
+ * @brief Precomputes gcd(L, S) and the modular inverses of both cycles.
+ */
+Way3::Way3(uint64_t _L, uint64_t _S) : L(_L), S(_S)
+{
+    if (L > MaxCapacity || S >= L)
+        throw std::invalid_argument("Way3: capacities must satisfy 2^62 >= L > S >= 0");
+
+    auto buildTimer = stats.Time(SearchPhase::Build);
+    g = Gcd(L, S);
+    invSmallMod = (S > 0) ? ModInverse(S / g, L / g) : 0;
+    invLargeMod = (S > 0) ? ModInverse((L / g) % (S / g), S / g) : 0;
+}
+
+/**
+ * @brief Solves for W and prints the result, like the constructors of Way1 and Way2.
+ */
+Way3::Way3(uint64_t _L, uint64_t _S, uint64_t _W, PathFormat format) : Way3(_L, _S)
+{
+    auto outputTimer = stats.Time(SearchPhase::Output);
+    Print(_W, format);
+}
+
+/**
+ * @brief Cycle A: fill the large jug, pour into the small jug, empty the small jug when full.
+ *
+ * After i fills of the large jug and m empties of the small jug, the large jug holds
+ * i*L - m*S. The smallest i >= 1 with i*L = W (mod S) gives the answer, and the last
+ * pour leaves the small jug full, so it has to be emptied once more at the end.
+ *
+ * Operations: i fills, i + m - 1 pours, m empties = 2i + 2m - 1.
+ */
+uint64_t Way3::CycleFillLarge(uint64_t W) const
+{
+    uint64_t Sg = S / g;
+    uint64_t rem;
+
+    // Smallest i >= 1 with i * (L/g) = W/g (mod S/g)
+    uint64_t i = MulMod((W / g) % Sg, invLargeMod, Sg);
+    if (i == 0)
+        i = Sg;
+
+    // m = (i*L - W) / S = floor(i*L / S) - floor(W / S), computed without overflow
+    uint64_t m = i * (L / S) + MulDiv(i, L % S, S, rem) - W / S;
+
+    return 2 * i + 2 * m - 1;
+}
+
+/**
+ * @brief Cycle B: fill the small jug, pour into the large jug, empty the large jug when full.
+ *
+ * After k fills of the small jug and j empties of the large jug, the large jug holds
+ * k*S - j*L. The smallest k >= 1 with k*S = W (mod L) gives the answer, and every fill
+ * and every empty is followed by exactly one pour.
+ *
+ * Operations: 2k + 2j, with j = floor(k*S / L).
+ */
+uint64_t Way3::CycleFillSmall(uint64_t W) const
+{
+    uint64_t Lg = L / g;
+    uint64_t rem;
+
+    // Smallest k >= 1 with k * (S/g) = W/g (mod L/g); W/g is never a multiple of L/g here
+    uint64_t k = MulMod((W / g) % Lg, invSmallMod, Lg);
+
+    uint64_t j = MulDiv(k, S, L, rem);
+
+    return 2 * k + 2 * j;
+}
+
+/**
+ * @brief Returns the minimum number of operations to reach (W, 0).
+ */
+uint64_t Way3::CountOperations(uint64_t W) const
+{
+    if (W == 0)
+        return 0;
+    if (W == L)
+        return 1; // Fill large jug
+
+    return std::min(CycleFillLarge(W), CycleFillSmall(W));
+}
+
+/**
+ * @brief Returns a lazy stream of the moves of the shorter of the two cycles.
+ */
+Way3::MoveStream Way3::Moves(uint64_t W) const
+{
+    MoveStream stream;
+    stream.L = L;
+    stream.S = S;
+    stream.remaining = CountOperations(W);
+    stream.fillLarge = (W == L) || (W > 0 && CycleFillLarge(W) <= CycleFillSmall(W));
+    return stream;
+}
+
+/**
+ * @brief Applies the next move of the selected cycle to the current state.
+ */
+bool Way3::MoveStream::Next(Move& move)
+{
+    if (remaining == 0)
+        return false;
+
+    if (fillLarge)
+    {
+        // === Cycle A: fill large, pour into small, empty small when full ===
+        if (big == 0)
+        {
+            move = Move::FillLarge;
+            big = L;
+        }
+        else if (small == S)
+        {
+            move = Move::EmptySmall;
+            small = 0;
+        }
+        else
+        {
+            move = Move::PourLargeToSmall;
+            uint64_t pour = std::min(big, S - small);
+            big -= pour;
+            small += pour;
+        }
+    }
+    else
+    {
+        // === Cycle B: fill small, pour into large, empty large when full ===
+        if (small == 0)
+        {
+            move = Move::FillSmall;
+            small = S;
+        }
+        else if (big == L)
+        {
+            move = Move::EmptyLarge;
+            big = 0;
+        }
+        else
+        {
+            move = Move::PourSmallToLarge;
+            uint64_t pour = std::min(small, L - big);
+            big += pour;
+            small -= pour;
+        }
+    }
+
+    remaining--;
+    return true;
+}
+
+/**
+ * @brief Prints the number of operations and streams the moves of the solution.
+ */
+void Way3::Print(uint64_t W, PathFormat format) const
+{
+    PathWriter writer(std::cout, format);
+    if (!Solvable(W))
+    {
+        writer.WriteNoSolution();
+        return;
+    }
+
+    MoveStream moves = Moves(W);
+    writer.Write(moves, moves.Remaining());
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include "PathWriter.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Third implementation of the water jug problem, using number theory instead of a search.
+ *
+ * Every shortest solution for two jugs follows one of two fixed pour cycles:
+ * - Cycle A: fill the large jug, pour it into the small one, empty the small one when full.
+ * - Cycle B: fill the small jug, pour it into the large one, empty the large one when full.
+ *
+ * The length of each cycle follows from gcd(L, S) and two modular inverses, so solvability
+ * and the exact number of operations are computed in O(log L) time. The moves themselves are
+ * produced lazily by MoveStream. All capacities are 64-bit, up to 2^62.
+ */
+class Way3
+{
+public:
+
+    static constexpr uint64_t MaxCapacity = uint64_t(1) << 62;  ///< Largest supported capacity
+
+    /**
+     * @brief Lazily generates the moves of a solution by simulating its pour cycle.
+     *
+     * Usable either through Next() or in a range-based for loop.
+     */
+    class MoveStream
+    {
+    public:
+        /**
+         * @brief Produces the next move of the solution.
+         *
+         * @param move Receives the move
+         * @return false once the solution is complete
+         */
+        bool Next(Move& move);
+
+        /**
+         * @brief Number of moves not yet produced.
+         */
+        uint64_t Remaining() const { return remaining; }
+
+        /**
+         * @brief Input iterator over the remaining moves.
+         */
+        class iterator
+        {
+        public:
+            Move operator*() const { return current; }
+            iterator& operator++() { done = !stream->Next(current); return *this; }
+            bool operator!=(const iterator& other) const { return done != other.done; }
+
+        private:
+            friend class MoveStream;
+            MoveStream* stream = nullptr;
+            Move current = Move::FillLarge;
+            bool done = true;
+        };
+
+        iterator begin() { iterator it; it.stream = this; return ++it; }
+        iterator end() { return iterator(); }
+
+    private:
+        friend class Way3;
+        uint64_t L = 0, S = 0;      ///< Jug capacities
+        uint64_t big = 0, small = 0; ///< Current state
+        uint64_t remaining = 0;      ///< Moves left to produce
+        bool fillLarge = true;       ///< true for cycle A, false for cycle B
+    };
+
+    /**
+     * @brief Precomputes gcd(L, S) and the modular inverses used by every query.
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @throws std::invalid_argument unless MaxCapacity >= L > S >= 0
+     */
+    Way3(uint64_t _L, uint64_t _S);
+
+    /**
+     * @brief Constructor - solves for W and prints the number of operations and the moves.
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @param _W Target amount to be reached in the large jug
+     * @param format How the solution is printed
+     */
+    Way3(uint64_t _L, uint64_t _S, uint64_t _W, PathFormat format = PathFormat::Full);
+
+    /**
+     * @brief Returns true if (W, 0) is reachable from (0, 0).
+     */
+    bool Solvable(uint64_t W) const { return W <= L && W % g == 0; }
+
+    /**
+     * @brief Returns the minimum number of operations to reach (W, 0). Requires Solvable(W).
+     */
+    uint64_t CountOperations(uint64_t W) const;
+
+    /**
+     * @brief Returns a lazy stream of the moves of a shortest solution. Requires Solvable(W).
+     */
+    MoveStream Moves(uint64_t W) const;
+
+    /**
+     * @brief Phase times of the precomputation and, for the printing constructor, of the output
+     * (all zero unless JUG_STATS is set). The closed form expands no states.
+     */
+    const SearchStats& Stats() const { return stats; }
+
+private:
+    uint64_t L, S;          ///< Capacities of the large and small jugs
+    uint64_t g;             ///< gcd(L, S)
+    uint64_t invSmallMod;   ///< Inverse of S/g modulo L/g (cycle B)
+    uint64_t invLargeMod;   ///< Inverse of L/g modulo S/g (cycle A)
+    SearchStats stats;      ///< Phase times (empty unless JUG_STATS is set)
+
+    /**
+     * @brief Length of cycle A (fill large jug first) for reaching (W, 0), with 0 < W < L.
+     */
+    uint64_t CycleFillLarge(uint64_t W) const;
+
+    /**
+     * @brief Length of cycle B (fill small jug first) for reaching (W, 0), with 0 < W < L.
+     */
+    uint64_t CycleFillSmall(uint64_t W) const;
+
+    /**
+     * @brief Prints the solution for W in the same format as Way1 and Way2.
+     */
+    void Print(uint64_t W, PathFormat format) const;
+};
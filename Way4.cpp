@@ -0,0 +1,105 @@
+#include "Way4.h"
+#include "Way1.h"
+#include "Common.h"
+
+/**
+ * @brief Runs the search on the engine's workers and prints the result.
+ */
+Way4::Way4(int _L, int _S, int _W, bool _print, PathFormat _format)
+    : L(_L), S(_S), W(_W), print(_print), format(_format), states(_L, _S)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool found = Search();
+    auto end = std::chrono::steady_clock::now();
+    searchMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    stats.AddTime(SearchPhase::Search, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    stats.Merge(engine.Stats());
+    stats.Allocate(engine.MemoryBytes());
+
+    if (print)
+    {
+        auto outputTimer = stats.Time(SearchPhase::Output);
+        Print(found);
+    }
+}
+
+/**
+ * @brief ParallelBfs over the StateIndex numbering, with the two-jug moves.
+ */
+bool Way4::Search()
+{
+    uint32_t goal = states.index(W, 0);
+
+    uint32_t found = engine.Search(states.size(), states.index(0, 0),
+        [&](uint32_t v) { return v == goal; },
+        [&](uint32_t u, auto emit)
+        {
+            auto [big, small] = states.state(u);
+            int toBig, toSmall;
+            for (int m = 0; m < MoveCount; m++)
+                if (ApplyMove(Move(m), L, S, big, small, toBig, toSmall))
+                    emit(states.index(toBig, toSmall));
+        },
+        [&](uint32_t v, auto emit)
+        {
+            auto [big, small] = states.state(v);
+            bool claimed = false;
+            ForEachPredecessor(L, S, big, small, [&](int fromBig, int fromSmall, Move)
+            {
+                if (!claimed)
+                    claimed = emit(states.index(fromBig, fromSmall));
+            });
+        });
+
+    return found != ParallelBfs::None;
+}
+
+/**
+ * @brief Reconstructs the path from the engine's parents and prints it.
+ */
+void Way4::Print(bool found) const
+{
+    PathWriter writer(std::cout, format);
+    if (!found)
+    {
+        writer.WriteNoSolution();
+        return;
+    }
+
+    std::vector<Move> path;
+    uint32_t start = states.index(0, 0);
+    for (uint32_t v = states.index(W, 0); v != start; v = engine.Parent(v))
+    {
+        // The operation from the parent is the one of its legal operations that leads to v
+        auto [big, small] = states.state(engine.Parent(v));
+        int toBig, toSmall;
+        for (int m = 0; m < MoveCount; m++)
+        {
+            if (ApplyMove(Move(m), L, S, big, small, toBig, toSmall) && states.index(toBig, toSmall) == v)
+            {
+                path.push_back(Move(m));
+                break;
+            }
+        }
+    }
+    std::reverse(path.begin(), path.end());
+
+    writer.Write(path, path.size());
+}
+
+/**
+ * @brief Runs both searches without output and prints their times and the speedup.
+ */
+void Way4::ReportSpeedup(int L, int S, int W)
+{
+    Way4 parallel(L, S, W, false);
+    Way1 serial(L, S, W, false);
+
+    long long p = std::max(1LL, parallel.SearchMicroseconds());
+    long long s = serial.SearchMicroseconds();
+
+    std::cout << "Parallel BFS (" << parallel.engine.Threads() << " threads, " << parallel.engine.ParallelLevels()
+        << " levels run in parallel): " << p << " microseconds, serial BFS (Way1): " << s
+        << " microseconds, speedup: " << double(s) / double(p) << "x\n";
+}
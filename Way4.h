@@ -0,0 +1,69 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include "PathWriter.h"
+#include "StateIndex.h"
+#include "SearchStats.h"
+#include "ParallelBfs.h"
+
+/**
+ * @brief Fourth implementation of the water jug problem: the multithreaded BFS of ParallelBfs.
+ *
+ * The two-jug states are numbered by StateIndex, and the successors and predecessors come from
+ * ApplyMove and ForEachPredecessor. ParallelBfs shares a level among its workers only when the
+ * level is wide, and the levels of two jugs hold at most four states, so this Way runs on the
+ * calling thread and mostly serves to check the engine against Way1. The speedup of the engine
+ * shows on three or more jugs, through Solver<N> and its Parallel strategy (Ex1 --jugs ...
+ * --strategy parallel).
+ */
+class Way4
+{
+public:
+
+    /**
+     * @brief Constructor - runs the parallel BFS and prints the solution.
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @param _W Target amount to be reached in the large jug
+     * @param _print Print the number of operations and the moves
+     * @param _format How the solution is printed
+     */
+    Way4(int _L, int _S, int _W, bool _print = true, PathFormat _format = PathFormat::Full);
+
+    /**
+     * @brief Time spent in the search itself, excluding output.
+     */
+    long long SearchMicroseconds() const { return searchMicroseconds; }
+
+    /**
+     * @brief Counters and phase times of the query, summed over all threads (all zero unless JUG_STATS is set).
+     */
+    const SearchStats& Stats() const { return stats; }
+
+    /**
+     * @brief Times the parallel search against the serial Way1::BFS on the same query and prints the speedup.
+     */
+    static void ReportSpeedup(int L, int S, int W);
+
+private:
+    int L, S, W;                    ///< Large jug size, small jug size, target amount
+    bool print;                     ///< Print the solution
+    PathFormat format;              ///< How the solution is printed
+    StateIndex states;              ///< Dense numbering of reachable states
+    ParallelBfs engine;             ///< The search and its workers
+    long long searchMicroseconds = 0;   ///< Duration of the search
+    SearchStats stats;              ///< Counters and phase times (empty unless JUG_STATS is set)
+
+    /**
+     * @brief Runs the BFS from (0, 0) until (W, 0) is reached or no states are left.
+     *
+     * @return true if (W, 0) is reachable
+     */
+    bool Search();
+
+    /**
+     * @brief Prints the number of operations and the moves, in the same format as Way1.
+     */
+    void Print(bool found) const;
+};
@@ -0,0 +1,164 @@
+#include "Way5.h"
+#include "Common.h"
+
+/**
+ * @brief Allocates the distance and parent arrays of both sides, runs the search and prints the result.
+ */
+Way5::Way5(int _L, int _S, int _W, bool _print, PathFormat _format)
+    : L(_L), S(_S), W(_W), print(_print), format(_format), states(_L, _S),
+      distF(states.size(), Unvisited), distB(states.size(), Unvisited),
+      prevF(states.size()), nextB(states.size()), viaF(states.size()), viaB(states.size())
+{
+    stats.Allocate(distF.size() * sizeof(uint32_t) * 4 + viaF.size() * sizeof(Move) * 2);
+
+    bool found;
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        found = Search();
+    }
+
+    if (print)
+    {
+        auto outputTimer = stats.Time(SearchPhase::Output);
+        Print(found);
+    }
+}
+
+/**
+ * @brief Forward step: applies every legal operation to the states of the forward frontier.
+ */
+void Way5::ExpandForward()
+{
+    int toBig, toSmall;
+    next.clear();
+
+    for (uint32_t U : frontF)
+    {
+        auto [big, small] = states.state(U);
+        stats.Expand();
+
+        for (int m = 0; m < MoveCount; m++)
+        {
+            if (!ApplyMove(Move(m), L, S, big, small, toBig, toSmall))
+                continue;
+
+            stats.Relax();
+            uint32_t V = states.index(toBig, toSmall);
+            if (distF[V] != Unvisited)
+                continue;
+
+            distF[V] = distF[U] + 1;
+            prevF[V] = U;
+            viaF[V] = Move(m);
+            next.push_back(V);
+
+            if (distB[V] != Unvisited) // Reached by the backward search too
+                Meet(V);
+            else
+                visitedCount++;
+        }
+    }
+
+    std::swap(frontF, next);
+    stats.Queue(frontF.size() + frontB.size());
+}
+
+/**
+ * @brief Backward step: finds every predecessor of the states of the backward frontier.
+ */
+void Way5::ExpandBackward()
+{
+    next.clear();
+
+    for (uint32_t U : frontB)
+    {
+        auto [big, small] = states.state(U);
+        stats.Expand();
+
+        ForEachPredecessor(L, S, big, small, [&](int fromBig, int fromSmall, Move move)
+        {
+            stats.Relax();
+            uint32_t V = states.index(fromBig, fromSmall);
+            if (distB[V] != Unvisited)
+                return;
+
+            distB[V] = distB[U] + 1;
+            nextB[V] = U;
+            viaB[V] = move;
+            next.push_back(V);
+
+            if (distF[V] != Unvisited) // Reached by the forward search too
+                Meet(V);
+            else
+                visitedCount++;
+        });
+    }
+
+    std::swap(frontB, next);
+    stats.Queue(frontF.size() + frontB.size());
+}
+
+/**
+ * @brief Expands whichever frontier is smaller, one whole level at a time.
+ *
+ * Once a level produces a meeting state, every shorter path would already have met
+ * in an earlier level, so the best meeting state of this level is optimal.
+ */
+bool Way5::Search()
+{
+    uint32_t start = states.index(0, 0);
+    uint32_t goal = states.index(W, 0);
+
+    distF[start] = 0;
+    distB[goal] = 0;
+    frontF = { start };
+    frontB = { goal };
+    visitedCount = (start == goal) ? 1 : 2;
+
+    if (start == goal)
+    {
+        meet = start;
+        return true;
+    }
+
+    while (!frontF.empty() && !frontB.empty())
+    {
+        if (frontF.size() <= frontB.size())
+            ExpandForward();
+        else
+            ExpandBackward();
+
+        if (meet != StateIndex::npos)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Prints the forward half-path up to the meeting state, then the backward half-path.
+ */
+void Way5::Print(bool found) const
+{
+    PathWriter writer(std::cout, format);
+    if (!found)
+    {
+        writer.WriteNoSolution();
+        return;
+    }
+
+    std::vector<Move> path;
+    uint32_t start = states.index(0, 0);
+    uint32_t goal = states.index(W, 0);
+
+    // === Forward half: walk back from the meeting state to (0, 0) ===
+    for (uint32_t v = meet; v != start; v = prevF[v])
+        path.push_back(viaF[v]);
+    std::reverse(path.begin(), path.end());
+
+    // === Backward half: walk on from the meeting state to (W, 0) ===
+    for (uint32_t v = meet; v != goal; v = nextB[v])
+        path.push_back(viaB[v]);
+
+    writer.Write(path, path.size());
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "Common.h"
+#include "Move.h"
+#include "PathWriter.h"
+#include "StateIndex.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Fifth implementation of the water jug problem: a bidirectional BFS.
+ *
+ * One search grows forward from (0, 0) with ApplyMove, the other grows backward from (W, 0)
+ * with ForEachPredecessor, since fill, empty and transfer are not symmetric. At every step
+ * the smaller frontier is expanded by one whole level. As soon as a level discovers a state
+ * already visited by the other side, the best meeting state of that level joins the two
+ * half-paths into a shortest solution.
+ */
+class Way5
+{
+public:
+
+    /**
+     * @brief Constructor - runs the bidirectional search and prints the solution.
+     *
+     * @param _L Capacity of the large jug
+     * @param _S Capacity of the small jug
+     * @param _W Target amount to be reached in the large jug
+     * @param _print Print the number of operations and the moves
+     * @param _format How the solution is printed
+     */
+    Way5(int _L, int _S, int _W, bool _print = true, PathFormat _format = PathFormat::Full);
+
+    /**
+     * @brief Number of distinct states visited by the two searches together.
+     */
+    uint64_t StatesVisited() const { return visitedCount; }
+
+    /**
+     * @brief Number of reachable states, i.e. the most a one-sided BFS can visit.
+     */
+    uint64_t StateCount() const { return states.size(); }
+
+    /**
+     * @brief Counters and phase times of the query, for both sides together (all zero unless JUG_STATS is set).
+     */
+    const SearchStats& Stats() const { return stats; }
+
+private:
+    static constexpr uint32_t Unvisited = UINT32_MAX;  ///< Distance of a state not yet reached
+
+    int L, S, W;                    ///< Large jug size, small jug size, target amount
+    bool print;                     ///< Print the solution
+    PathFormat format;              ///< How the solution is printed
+    StateIndex states;              ///< Dense numbering of reachable states
+    std::vector<uint32_t> distF;    ///< Distance from (0, 0), forward search
+    std::vector<uint32_t> distB;    ///< Distance to (W, 0), backward search
+    std::vector<uint32_t> prevF;    ///< Forward parent (one step closer to (0, 0))
+    std::vector<uint32_t> nextB;    ///< Backward parent (one step closer to (W, 0))
+    std::vector<Move> viaF;         ///< Operation from prevF[v] to v
+    std::vector<Move> viaB;         ///< Operation from v to nextB[v]
+    std::vector<uint32_t> frontF, frontB, next; ///< Current frontiers and scratch for the next level
+    uint32_t meet = StateIndex::npos;   ///< State where the two searches join
+    uint32_t best = Unvisited;          ///< Length of the shortest joined path found so far
+    uint64_t visitedCount = 0;          ///< Distinct states visited by either search
+    SearchStats stats;                  ///< Counters and phase times (empty unless JUG_STATS is set)
+
+    /**
+     * @brief Records v as a meeting state if it joins a shorter path.
+     */
+    void Meet(uint32_t v)
+    {
+        if (distF[v] + distB[v] < best)
+        {
+            best = distF[v] + distB[v];
+            meet = v;
+        }
+    }
+
+    /**
+     * @brief Expands the forward frontier by one level.
+     */
+    void ExpandForward();
+
+    /**
+     * @brief Expands the backward frontier by one level.
+     */
+    void ExpandBackward();
+
+    /**
+     * @brief Alternates the two searches until they meet or one runs out of states.
+     *
+     * @return true if (W, 0) is reachable
+     */
+    bool Search();
+
+    /**
+     * @brief Joins the two half-paths and prints them, in the same format as Way1.
+     */
+    void Print(bool found) const;
+};
@@ -0,0 +1,156 @@
+#include "WeightedSolver.h"
+#include "Common.h"
+
+/**
+ * @brief 0-1 BFS when it is exact, a bucket ring while the ring stays small, a radix heap otherwise.
+ */
+WeightedSolver::Queue WeightedSolver::QueueFor(const CostModel& costs)
+{
+    if (costs.IsZeroOne())
+        return Queue::ZeroOne;
+    return costs.MaxCost() <= DialMaxCost ? Queue::Dial : Queue::Radix;
+}
+
+/**
+ * @brief Prepares the pooled buffers, runs the search with the selected queue and rebuilds the path.
+ */
+WeightedSolver::Result WeightedSolver::Solve(int L, int S, int W)
+{
+    if (S < 0 || L <= S)
+        throw std::invalid_argument("WeightedSolver: capacities must satisfy 0 <= S < L");
+
+    Result result;
+    result.queue = QueueFor(costs);
+    if (W < 0 || W > L)
+        return result;
+
+    SearchStats& stats = result.stats;
+    StateIndex states(L, S);
+    uint32_t n = states.size();
+
+    // === Prepare the pooled buffers ===
+    {
+        auto buildTimer = stats.Time(SearchPhase::Build);
+        std::size_t before = MemoryBytes();
+        dist.assign(n, Unreached);
+        if (costs.MinCost() == 0)
+            hops.resize(n);
+        if (result.queue == Queue::Radix)
+            radix.Reset();
+        else
+            buckets.Reset(costs.MaxCost());    // one bucket per possible cost: only for small costs
+        stats.Allocate(MemoryBytes() - before);
+    }
+
+    bool found;
+    {
+        auto searchTimer = stats.Time(SearchPhase::Search);
+        found = (result.queue == Queue::Radix)
+            ? Search(states, L, S, W, stats, radix)
+            : Search(states, L, S, W, stats, buckets);
+    }
+    if (!found)
+        return result;
+
+    {
+        auto pathTimer = stats.Time(SearchPhase::Path);
+        RebuildPath(states, L, S, W);
+    }
+
+    result.solved = true;
+    result.cost = dist[states.index(W, 0)];
+    result.operations = uint32_t(path.size());
+    result.moves = path;
+    return result;
+}
+
+/**
+ * @brief Dijkstra with lazy deletion: a state may be queued once per improvement of its cost,
+ * and entries whose key is above the state's current cost are skipped when popped.
+ *
+ * Neighbors are relaxed in Move order, as generated by Graph::generateAllEdges.
+ */
+template <typename PriorityQueue>
+bool WeightedSolver::Search(const StateIndex& states, int L, int S, int W, SearchStats& stats, PriorityQueue& queue)
+{
+    uint32_t start = states.index(0, 0);
+    uint32_t goal = states.index(W, 0);
+
+    const bool trackHops = costs.MinCost() == 0;
+    dist[start] = 0;
+    if (trackHops)
+        hops[start] = 0;
+    queue.Push(0, start);
+    std::size_t queued = 1;
+
+    while (!queue.Empty())
+    {
+        uint64_t key;
+        uint32_t U = queue.Pop(key);
+        queued--;
+        if (key > dist[U])  // stale entry, the state was settled with a lower cost
+            continue;
+        if (U == goal)      // settled: no cheaper path remains
+            return true;
+
+        auto [big, small] = states.state(U);
+        stats.Expand();
+
+        int toBig, toSmall;
+        for (int m = 0; m < MoveCount; m++)
+        {
+            if (!ApplyMove(Move(m), L, S, big, small, toBig, toSmall))
+                continue;
+
+            stats.Relax();
+            uint32_t V = states.index(toBig, toSmall);
+            uint64_t through = key + costs[Move(m)];
+            if (through < dist[V])
+            {
+                dist[V] = through;
+                if (trackHops)
+                    hops[V] = hops[U] + 1;
+                queue.Push(through, V);
+                queued++;
+            }
+        }
+        stats.Queue(queued);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Walks back from (W, 0): at each state, takes the first predecessor P reached with
+ * operation m such that dist[P] + cost(m) = dist[state], which lies on a minimum-cost path.
+ *
+ * The state's final cost was set by relaxing from a settled state, which is such a predecessor,
+ * so one always exists. With free operations it must also be one operation closer to (0, 0).
+ */
+void WeightedSolver::RebuildPath(const StateIndex& states, int L, int S, int W)
+{
+    const bool trackHops = costs.MinCost() == 0;
+    path.clear();
+    int big = W, small = 0;
+    while (big != 0 || small != 0)
+    {
+        uint32_t v = states.index(big, small);
+        uint64_t cost = dist[v];
+        bool stepped = false;
+
+        ForEachPredecessor(L, S, big, small, [&](int fromBig, int fromSmall, Move move)
+        {
+            if (stepped)
+                return;
+            uint32_t p = states.index(fromBig, fromSmall);
+            if (dist[p] != Unreached && dist[p] + costs[move] == cost && (!trackHops || hops[p] + 1 == hops[v]))
+            {
+                path.push_back(move);
+                big = fromBig;
+                small = fromSmall;
+                stepped = true;
+            }
+        });
+    }
+    std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "Common.h"
+#include "JugSolver.h"
+#include "Move.h"
+#include "CostModel.h"
+#include "StateIndex.h"
+#include "BucketQueue.h"
+#include "SearchStats.h"
+
+/**
+ * @brief Reusable minimum-cost solver for the two-jug problem, with a cost per operation.
+ *
+ * Where JugSolver minimizes the number of operations, a WeightedSolver minimizes the sum of
+ * their costs under a CostModel. The search is Dijkstra's algorithm over the same on-the-fly
+ * neighbors, with the queue picked from the costs:
+ * - all costs 0 or 1: a 0-1 BFS, i.e. a BucketQueue of two buckets (this level and the next),
+ *   where 0-cost edges stay in the current level;
+ * - largest cost up to DialMaxCost: Dial's bucket queue, one bucket per possible cost;
+ * - larger costs: a radix heap.
+ *
+ * The only per-state array is the cost of every state. With weights the parent of a state is
+ * not always the one InverseMove would infer, so the path is rebuilt backwards by looking for
+ * a predecessor (ForEachPredecessor) whose cost plus the operation's cost gives the state's cost.
+ * When some operation is free, such predecessors can form cycles, so the number of operations
+ * of every state's path is kept as well and must drop by one at each step back.
+ */
+class WeightedSolver
+{
+public:
+
+    static constexpr uint32_t DialMaxCost = 1 << 16;    ///< Largest cost handled with a bucket ring
+
+    /**
+     * @brief Queue used by a search.
+     */
+    enum class Queue
+    {
+        ZeroOne,    ///< BucketQueue of two buckets (0-1 BFS)
+        Dial,       ///< BucketQueue
+        Radix       ///< RadixHeap
+    };
+
+    /**
+     * @brief Outcome of one query, with its cost.
+     */
+    struct Result : JugSolver::Result
+    {
+        uint64_t cost = 0;              ///< Minimum total cost (0 if not solved)
+        Queue queue = Queue::ZeroOne;   ///< Queue the search used
+    };
+
+    /**
+     * @brief Creates a solver for one cost model.
+     */
+    explicit WeightedSolver(const CostModel& _costs = CostModel()) : costs(_costs) {}
+
+    /**
+     * @brief Finds a minimum-cost sequence of operations from (0, 0) to (W, 0).
+     *
+     * @param L Capacity of the large jug
+     * @param S Capacity of the small jug, 0 <= S < L
+     * @param W Target amount in the large jug
+     * @throws std::invalid_argument if the capacities are out of range
+     */
+    Result Solve(int L, int S, int W);
+
+    /**
+     * @brief Returns the queue a search with these costs uses.
+     */
+    static Queue QueueFor(const CostModel& costs);
+
+    const CostModel& Costs() const { return costs; }   ///< Cost of each operation
+
+    /**
+     * @brief Memory currently held by the scratch buffers, in bytes.
+     */
+    std::size_t MemoryBytes() const
+    {
+        return dist.capacity() * sizeof(uint64_t) + hops.capacity() * sizeof(uint32_t) + buckets.MemoryBytes() + radix.MemoryBytes()
+            + path.capacity() * sizeof(Move);
+    }
+
+private:
+    static constexpr uint64_t Unreached = UINT64_MAX;  ///< Distance of a state not reached yet
+
+    CostModel costs;                ///< Cost of each operation
+    std::vector<uint64_t> dist;     ///< Best known cost of each state
+    std::vector<uint32_t> hops;     ///< Operations on the path that gave each state its cost (only with free operations)
+    BucketQueue<> buckets;          ///< Dial and 0-1 BFS queue
+    RadixHeap radix;                ///< Queue for large costs
+    std::vector<Move> path;         ///< Moves of the last solution
+
+    /**
+     * @brief Dijkstra from (0, 0) with the given queue, stopping when (W, 0) is settled.
+     *
+     * @param queue BucketQueue or RadixHeap, already empty
+     * @return true if (W, 0) was reached
+     */
+    template <typename PriorityQueue>
+    bool Search(const StateIndex& states, int L, int S, int W, SearchStats& stats, PriorityQueue& queue);
+
+    /**
+     * @brief Fills `path` with the moves from (0, 0) to (W, 0), found backwards from `dist`.
+     */
+    void RebuildPath(const StateIndex& states, int L, int S, int W);
+};
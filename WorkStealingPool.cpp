@@ -0,0 +1,143 @@
+#include "WorkStealingPool.h"
+
+thread_local WorkStealingPool* WorkStealingPool::currentPool = nullptr;
+thread_local unsigned WorkStealingPool::currentIndex = 0;
+
+/**
+ * @brief Creates one queue per worker, then starts the workers.
+ */
+WorkStealingPool::WorkStealingPool(unsigned workerCount)
+{
+    if (workerCount == 0)
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < workerCount; i++)
+        queues.push_back(std::make_unique<Queue>());
+
+    for (unsigned i = 0; i < workerCount; i++)
+        workers.emplace_back(&WorkStealingPool::Work, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+/**
+ * @brief Pushes the task on the caller's own queue if it is a worker, round-robin otherwise.
+ */
+void WorkStealingPool::Submit(Task task)
+{
+    unsigned index = (currentPool == this)
+        ? currentIndex
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % unsigned(queues.size());
+
+    unfinished.fetch_add(1);
+    queued.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    // A worker about to sleep checks `queued` under idleMutex, so taking it here cannot lose the wakeup
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+    }
+    workReady.notify_one();
+}
+
+/**
+ * @brief Sleeps until the unfinished count drops to zero.
+ */
+void WorkStealingPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(idleMutex);
+    allDone.wait(lock, [&] { return unfinished.load() == 0; });
+
+    if (error)
+    {
+        std::exception_ptr first = error;
+        error = nullptr;
+        std::rethrow_exception(first);
+    }
+}
+
+/**
+ * @brief Own queue from the back (LIFO), other queues from the front (FIFO), starting after our own.
+ */
+bool WorkStealingPool::Take(unsigned index, Task& task)
+{
+    {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    const unsigned count = unsigned(queues.size());
+    for (unsigned k = 1; k < count; k++)
+    {
+        Queue& victim = *queues[(index + k) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Runs tasks until shutdown; an exception thrown by a task is kept for Wait.
+ */
+void WorkStealingPool::Work(unsigned index)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    while (true)
+    {
+        Task task;
+        if (Take(index, task))
+        {
+            queued.fetch_sub(1);
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+
+            if (unfinished.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        workReady.wait(lock, [&] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0)
+            return;
+    }
+}
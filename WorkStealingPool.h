@@ -0,0 +1,102 @@
+#pragma once
+#include "Common.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Fixed pool of worker threads, each with its own task queue, that steal from each other.
+ *
+ * Tasks submitted from outside the pool are spread over the queues round-robin; tasks submitted
+ * by a running task go to the queue of the worker running it. A worker takes its newest task
+ * first (the data it just produced is still in cache) and, when its queue is empty, steals the
+ * oldest task of another worker (the one most likely to be large). Uneven tasks, such as BFS
+ * runs over very different capacities, therefore keep every core busy until the end.
+ *
+ * Each queue has its own lock, so workers only contend when stealing.
+ */
+class WorkStealingPool
+{
+public:
+
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Starts the workers.
+     *
+     * @param workerCount Number of worker threads (0 = one per hardware thread)
+     */
+    explicit WorkStealingPool(unsigned workerCount = 0);
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Runs the tasks still queued, then stops and joins the workers.
+     */
+    ~WorkStealingPool();
+
+    /**
+     * @brief Queues a task. Safe to call from any thread, including from a running task.
+     */
+    void Submit(Task task);
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     *
+     * @throws The first exception thrown by a task since the last Wait, if any
+     */
+    void Wait();
+
+    unsigned WorkerCount() const { return unsigned(workers.size()); }  ///< Number of worker threads
+
+    /**
+     * @brief Number of tasks taken from another worker's queue so far.
+     */
+    uint64_t Steals() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+
+    /**
+     * @brief Task queue of one worker.
+     */
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;     ///< One queue per worker
+    std::vector<std::thread> workers;               ///< Worker threads
+
+    std::mutex idleMutex;                           ///< Guards stopping and error, and the sleeps below
+    std::condition_variable workReady;              ///< Signaled when a task is queued or on shutdown
+    std::condition_variable allDone;                ///< Signaled when the last unfinished task finishes
+    bool stopping = false;                          ///< Workers exit once the queues are empty
+    std::exception_ptr error;                       ///< First exception thrown by a task
+
+    std::atomic<uint64_t> queued{ 0 };              ///< Tasks in the queues
+    std::atomic<uint64_t> unfinished{ 0 };          ///< Tasks submitted and not finished yet
+    std::atomic<uint64_t> steals{ 0 };              ///< Tasks stolen so far
+    std::atomic<uint32_t> nextQueue{ 0 };           ///< Round-robin position for outside submits
+
+    static thread_local WorkStealingPool* currentPool;  ///< Pool of the calling worker thread, if any
+    static thread_local unsigned currentIndex;          ///< Index of the calling worker thread
+
+    /**
+     * @brief Worker thread: runs its own tasks, then stolen ones, and sleeps when there are none.
+     */
+    void Work(unsigned index);
+
+    /**
+     * @brief Takes a task: the newest of queue `index`, or else the oldest of another queue.
+     *
+     * @return false if every queue is empty
+     */
+    bool Take(unsigned index, Task& task);
+};